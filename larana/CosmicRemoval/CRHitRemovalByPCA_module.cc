@@ -28,7 +28,6 @@
 #include "canvas/Persistency/Common/Assns.h"
 #include "canvas/Persistency/Common/FindManyP.h"
 #include "canvas/Persistency/Common/Ptr.h"
-#include "canvas/Persistency/Common/PtrVector.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 #include "lardataobj/AnalysisBase/CosmicTag.h"
@@ -39,28 +38,23 @@
 // Local functions.
 namespace {
   //----------------------------------------------------------------------------
-  // Filter a collection of hits (set difference).
-  // This function is copied from Track3DKalmanHit_module.cc
+  // Flag a list of hits in a bitset indexed by hit key.
   //
   // Arguments:
   //
-  // hits      - Hit collection from which hits should be removed.
-  // used_hits - Hits to remove.
+  // hits   - Hits to flag.
+  // hitID  - Product ID of the hit collection the bitset refers to; hits from
+  //          other collections are ignored.
+  // value  - Value to set the flag of each hit to.
+  // marked - Bitset, one entry per hit of the collection.
   //
-  void FilterHits(art::PtrVector<recob::Hit>& hits, art::PtrVector<recob::Hit>& used_hits)
+  void MarkHits(const std::vector<art::Ptr<recob::Hit>>& hits,
+                const art::ProductID& hitID,
+                bool value,
+                std::vector<bool>& marked)
   {
-    if (used_hits.size() > 0) {
-      // Make sure both hit collections are sorted.
-      std::stable_sort(hits.begin(), hits.end());
-      std::stable_sort(used_hits.begin(), used_hits.end());
-
-      // Do set difference operation.
-      art::PtrVector<recob::Hit>::iterator it = std::set_difference(
-        hits.begin(), hits.end(), used_hits.begin(), used_hits.end(), hits.begin());
-
-      // Truncate hit collection.
-      hits.erase(it, hits.end());
-    }
+    for (const auto& hit : hits)
+      if (hit.id() == hitID) marked[hit.key()] = value;
   }
 }
 
@@ -82,7 +76,7 @@ private:
                         const art::FindManyP<recob::Cluster>& partToClusAssns,
                         const art::FindManyP<recob::Hit>& clusToHitAssns,
                         std::set<const recob::PFParticle*>& taggedParticles,
-                        art::PtrVector<recob::Hit>& hitVec);
+                        std::vector<art::Ptr<recob::Hit>>& hitVec);
 
   // Fcl parameters.
   std::string fCosmicProducerLabel;     ///< Module that produced the PCA based cosmic tags
@@ -193,7 +187,7 @@ void CRHitRemovalByPCA::produce(art::Event& evt)
   art::FindManyP<recob::Hit> clusterHitAssns(clusterHandle, evt, fPFParticleProducerLabel);
 
   // Container to contain the "bad" hits...
-  art::PtrVector<recob::Hit> taggedHits;
+  std::vector<art::Ptr<recob::Hit>> taggedHits;
 
   // No point double counting hits
   std::set<const recob::PFParticle*> taggedSet;
@@ -232,7 +226,7 @@ void CRHitRemovalByPCA::produce(art::Event& evt)
     // First order of business is to attempt to restore any hits which are shared between a tagged
     // CR PFParticle and an untagged one. We can do this by going through the PFParticles and
     // "removing" hits which are in the not tagged set.
-    art::PtrVector<recob::Hit> untaggedHits;
+    std::vector<art::Ptr<recob::Hit>> untaggedHits;
 
     for (const auto& pfParticle : *pfParticleHandle) {
       if (taggedSet.find(&pfParticle) != taggedSet.end()) continue;
@@ -247,33 +241,26 @@ void CRHitRemovalByPCA::produce(art::Event& evt)
       }
     }
 
-    // Filter out the hits we want to save
-    FilterHits(taggedHits, untaggedHits);
+    // Filter out the hits we want to save: flag the tagged hits by their key in the
+    // original collection, then clear the flags of the shared ones
+    std::vector<bool> taggedHitFlags(hitHandle->size(), false);
 
-    // The below is rather ugly but there is an interplay between art::Ptr's and the
-    // actual pointers to objects that I might be missing and this is what I see how to do
-    // First move all the original art::Ptr hits into a local art::PtrVector
-    art::PtrVector<recob::Hit> originalHits;
-
-    // Fill this one hit at a time...
-    for (size_t hitIdx = 0; hitIdx != hitHandle->size(); hitIdx++) {
-      art::Ptr<recob::Hit> hit(hitHandle, hitIdx);
-
-      originalHits.push_back(hit);
-    }
-
-    // Remove the cosmic ray tagged hits
-    FilterHits(originalHits, taggedHits);
+    MarkHits(taggedHits, hitHandle.id(), true, taggedHitFlags);
+    MarkHits(untaggedHits, hitHandle.id(), false, taggedHitFlags);
 
     // Clear the current outputHits vector since we're going to refill...
     outputHits->clear();
 
-    // Now make the new list of output hits
-    for (const auto& hit : originalHits) {
+    // Now make the new list of output hits, removing the cosmic ray tagged hits
+    for (size_t hitIdx = 0; hitIdx != hitHandle->size(); hitIdx++) {
+      if (taggedHitFlags[hitIdx]) continue;
+
+      const recob::Hit& hit = (*hitHandle)[hitIdx];
+
       // Kludge to remove out of time hits
-      if (hit->StartTick() > 6400 || hit->EndTick() < 3200) continue;
+      if (hit.StartTick() > 6400 || hit.EndTick() < 3200) continue;
 
-      outputHits->emplace_back(*hit);
+      outputHits->emplace_back(hit);
     }
   }
 
@@ -302,7 +289,7 @@ void CRHitRemovalByPCA::removeTaggedHits(
   const art::FindManyP<recob::Cluster>& partToClusAssns,
   const art::FindManyP<recob::Hit>& clusToHitAssns,
   std::set<const recob::PFParticle*>& taggedParticles,
-  art::PtrVector<recob::Hit>& hitVec)
+  std::vector<art::Ptr<recob::Hit>>& hitVec)
 {
   // Recover the clusters associated to the input PFParticle
   std::vector<art::Ptr<recob::Cluster>> clusterVec = partToClusAssns.at(pfParticle->Self());
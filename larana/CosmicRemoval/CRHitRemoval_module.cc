@@ -64,6 +64,7 @@ private:
                              const art::Handle<std::vector<recob::PFParticle>>& pfParticleHandle,
                              const art::FindManyP<recob::Cluster>& partToClusAssns,
                              const art::FindManyP<recob::Hit>& clusToHitAssns,
+                             std::vector<bool>& visited,
                              HitPtrVector& hitVec);
 
   void copyAllHits(std::vector<art::Ptr<recob::Hit>>&,
@@ -74,7 +75,11 @@ private:
                       art::FindOneP<recob::Wire>&,
                       recob::HitCollectionCreator&);
 
-  void FilterHits(HitPtrVector& hits, HitPtrVector& used_hits);
+  void MarkHits(const HitPtrVector& hits,
+                const art::ProductID& hitID,
+                bool value,
+                std::vector<bool>& marked) const;
+  void FilterHits(HitPtrVector& hits, const std::vector<bool>& used_hits) const;
 
   // Fcl parameters.
   std::vector<std::string> fCosmicProducerLabels; ///< List of cosmic tagger producers
@@ -237,6 +242,10 @@ void CRHitRemoval::produce(art::Event& evt)
         std::map<int, std::vector<art::Ptr<recob::Track>>> cosmicToTrackVecMap;
         std::map<int, std::vector<art::Ptr<recob::PFParticle>>> trackToPFParticleVecMap;
 
+        // Look up the track to PFParticle associations once for all the tags
+        art::FindManyP<recob::PFParticle> trackPFParticleAssns(
+          trackHandle, evt, fAssnProducerLabels[idx]);
+
         // Loop through the cosmic tags
         for (size_t cosmicIdx = 0; cosmicIdx < cosmicHandle->size(); cosmicIdx++) {
           art::Ptr<anab::CosmicTag> cosmicTag(cosmicHandle, cosmicIdx);
@@ -246,9 +255,6 @@ void CRHitRemoval::produce(art::Event& evt)
 
           cosmicToTrackVecMap[cosmicTag.key()] = cosmicToTrackVec;
 
-          art::FindManyP<recob::PFParticle> trackPFParticleAssns(
-            trackHandle, evt, fAssnProducerLabels[idx]);
-
           for (auto& track : cosmicToTrackVec) {
             std::vector<art::Ptr<recob::PFParticle>> trackToPFParticleVec =
               trackPFParticleAssns.at(track.key());
@@ -285,8 +291,9 @@ void CRHitRemoval::produce(art::Event& evt)
   // Likewise, recover the collection of associations to hits
   art::FindManyP<recob::Hit> clusterHitAssns(clusterHandle, evt, fPFParticleProducerLabel);
 
-  // No point double counting hits
-  std::set<const recob::PFParticle*> taggedSet;
+  // No point double counting hits: flag the tagged PFParticles by their index
+  std::vector<bool> taggedParticles(pfParticleHandle->size(), false);
+  bool anyTagged(false);
 
   // Start the identification of hits to remove. The outer loop is over the various producers of
   // the CosmicTag objects we're examininig
@@ -323,7 +330,8 @@ void CRHitRemoval::produce(art::Event& evt)
                   art::Ptr<recob::PFParticle>(pfParticleHandle, pfParticle->Parent()).get();
 
               // Add to our list of tagged PFParticles
-              taggedSet.insert(pfParticle);
+              taggedParticles[pfParticle->Self()] = true;
+              anyTagged = true;
             }
           }
         }
@@ -332,7 +340,7 @@ void CRHitRemoval::produce(art::Event& evt)
   }
 
   // If no PFParticles have been tagged then nothing to do
-  if (!taggedSet.empty()) {
+  if (anyTagged) {
     // This may all seem backwards... but what you want to do is remove all the hits which are associated to tagged
     // cosmic ray tracks/PFParticles and what you want to leave is all other hits. This includes hits on other PFParticles
     // as well as unassociated (as yet) hits.
@@ -346,6 +354,9 @@ void CRHitRemoval::produce(art::Event& evt)
     HitPtrVector taggedHits;
     HitPtrVector untaggedHits;
 
+    // PFParticles whose hits have already been collected
+    std::vector<bool> visitedParticles(pfParticleHandle->size(), false);
+
     // Loop through the PFParticles and build out the list of hits on untagged PFParticle trees
     for (const auto& pfParticle : *pfParticleHandle) {
       // Start with only primaries
@@ -355,13 +366,18 @@ void CRHitRemoval::produce(art::Event& evt)
       HitPtrVector tempHits;
 
       // Find the hits associated to this untagged PFParticle
-      collectPFParticleHits(&pfParticle, pfParticleHandle, clusterAssns, clusterHitAssns, tempHits);
+      collectPFParticleHits(&pfParticle,
+                            pfParticleHandle,
+                            clusterAssns,
+                            clusterHitAssns,
+                            visitedParticles,
+                            tempHits);
 
       // One more possible chance at identifying tagged hits...
       // Check these hits to see if any lie outside time window
       bool goodHits(true);
 
-      if (taggedSet.find(&pfParticle) != taggedSet.end()) goodHits = false;
+      if (taggedParticles[pfParticle.Self()]) goodHits = false;
 
       if (goodHits) {
         int nOutOfTime(0);
@@ -385,10 +401,13 @@ void CRHitRemoval::produce(art::Event& evt)
     }
 
     // First task - remove hits from the tagged hit collection that are inthe untagged hits (shared hits)
-    FilterHits(taggedHits, untaggedHits);
+    std::vector<bool> taggedHitFlags(hitHandle->size(), false);
+
+    MarkHits(taggedHits, hitHandle.id(), true, taggedHitFlags);
+    MarkHits(untaggedHits, hitHandle.id(), false, taggedHitFlags);
 
     // Now filter the tagged hits from the total hit collection
-    FilterHits(ChHits, taggedHits);
+    FilterHits(ChHits, taggedHitFlags);
   }
 
   // Copy our new hit collection to the output
@@ -407,6 +426,7 @@ void CRHitRemoval::produce(art::Event& evt)
 /// pfParticleHandle - handle to the PFParticle objects
 /// partToClusAssns - list of PFParticle to Cluster associations
 /// clusToHitAssns - list of Cluster to Hit associations
+/// visited - flags the PFParticles already collected, indexed by PFParticle::Self()
 /// hitVec - the current list of hits
 ///
 /// This recursively called method will remove all hits associated to an input
@@ -418,8 +438,13 @@ void CRHitRemoval::collectPFParticleHits(
   const art::Handle<std::vector<recob::PFParticle>>& pfParticleHandle,
   const art::FindManyP<recob::Cluster>& partToClusAssns,
   const art::FindManyP<recob::Hit>& clusToHitAssns,
+  std::vector<bool>& visited,
   HitPtrVector& hitVec)
 {
+  // Each PFParticle contributes its hits only once
+  if (visited[pfParticle->Self()]) return;
+  visited[pfParticle->Self()] = true;
+
   // Recover the clusters associated to the input PFParticle
   std::vector<art::Ptr<recob::Cluster>> clusterVec = partToClusAssns.at(pfParticle->Self());
 
@@ -453,7 +478,7 @@ void CRHitRemoval::collectPFParticleHits(
     art::Ptr<recob::PFParticle> daughter(pfParticleHandle, daughterId);
 
     collectPFParticleHits(
-      daughter.get(), pfParticleHandle, partToClusAssns, clusToHitAssns, hitVec);
+      daughter.get(), pfParticleHandle, partToClusAssns, clusToHitAssns, visited, hitVec);
   }
 
   return;
@@ -492,28 +517,41 @@ void CRHitRemoval::copyInTimeHits(std::vector<art::Ptr<recob::Hit>>& inputHits,
 }
 
 //----------------------------------------------------------------------------
-// Filter a collection of hits (set difference).
-// This function is copied from Track3DKalmanHit_module.cc
+// Flag a list of hits in a bitset indexed by hit key.
 //
 // Arguments:
 //
-// hits      - Hit collection from which hits should be removed.
-// used_hits - Hits to remove.
+// hits   - Hits to flag.
+// hitID  - Product ID of the hit collection the bitset refers to; hits from
+//          other collections are ignored.
+// value  - Value to set the flag of each hit to.
+// marked - Bitset, one entry per hit of the collection.
 //
-void CRHitRemoval::FilterHits(HitPtrVector& hits, HitPtrVector& used_hits)
+void CRHitRemoval::MarkHits(const HitPtrVector& hits,
+                            const art::ProductID& hitID,
+                            bool value,
+                            std::vector<bool>& marked) const
 {
-  if (used_hits.size() > 0) {
-    // Make sure both hit collections are sorted.
-    std::stable_sort(hits.begin(), hits.end());
-    std::stable_sort(used_hits.begin(), used_hits.end());
-
-    // Do set difference operation.
-    std::vector<art::Ptr<recob::Hit>>::iterator it = std::set_difference(
-      hits.begin(), hits.end(), used_hits.begin(), used_hits.end(), hits.begin());
+  for (const auto& hit : hits)
+    if (hit.id() == hitID) marked[hit.key()] = value;
+}
 
-    // Truncate hit collection.
-    hits.erase(it, hits.end());
-  }
+//----------------------------------------------------------------------------
+// Filter a collection of hits (set difference), keeping the input order.
+//
+// Arguments:
+//
+// hits      - Hit collection from which hits should be removed.
+// used_hits - Bitset indexed by hit key flagging the hits to remove.
+//
+void CRHitRemoval::FilterHits(HitPtrVector& hits, const std::vector<bool>& used_hits) const
+{
+  hits.erase(std::remove_if(hits.begin(),
+                            hits.end(),
+                            [&used_hits](const art::Ptr<recob::Hit>& hit) {
+                              return used_hits[hit.key()];
+                            }),
+             hits.end());
 }
 
 //----------------------------------------------------------------------------
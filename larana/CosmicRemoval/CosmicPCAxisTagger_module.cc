@@ -62,6 +62,7 @@ private:
   lar_cluster3d::PrincipalComponentsAlg fPcaAlg; ///<  Principal Components algorithm
 
   int fDetectorWidthTicks;
+  double fMinTickDrift, fMaxTickDrift; ///< Window of the in time hits
   float fTPCXBoundary, fTPCYBoundary, fTPCZBoundary;
   float fDetHalfHeight, fDetWidth, fDetLength;
 };
@@ -92,6 +93,8 @@ cosmic::CosmicPCAxisTagger::CosmicPCAxisTagger(fhicl::ParameterSet const& p)
 
   fDetectorWidthTicks =
     2 * geo->DetHalfWidth() / (driftVelocity * fSamplingRate / 1000); // ~3200 for uB
+  fMinTickDrift = fDetectorWidthTicks;
+  fMaxTickDrift = 2. * fDetectorWidthTicks;
 
   produces<std::vector<anab::CosmicTag>>();
   produces<art::Assns<recob::PFParticle, anab::CosmicTag>>();
@@ -209,8 +212,11 @@ void cosmic::CosmicPCAxisTagger::produce(art::Event& evt)
 
     // Once we have the clusters then we can loop over them to find the associated hits
     for (const auto& cluster : clusterVec) {
+      // One out of time hit is enough, no need to look at the other clusters
+      if (isCosmic != 0) break;
+
       // Recover the 2D hits associated to a given cluster
-      std::vector<art::Ptr<recob::Hit>> hitVec = clusterHitAssns.at(cluster->ID());
+      const std::vector<art::Ptr<recob::Hit>>& hitVec = clusterHitAssns.at(cluster->ID());
 
       // Once we have the hits the first thing we should do is to check if any are "out of time"
       // If there are out of time hits then we are going to reject the cluster so no need to do
@@ -224,8 +230,7 @@ void cosmic::CosmicPCAxisTagger::produce(art::Event& evt)
                     << ", peak + RMS: " << hit->PeakTimePlusRMS()
                     << ", det width: " << fDetectorWidthTicks << std::endl;
         }
-        if (hit->PeakTimeMinusRMS() < fDetectorWidthTicks ||
-            hit->PeakTimePlusRMS() > 2. * fDetectorWidthTicks) {
+        if (hit->PeakTimeMinusRMS() < fMinTickDrift || hit->PeakTimePlusRMS() > fMaxTickDrift) {
           isCosmic = 1;
           tag_id = anab::CosmicTagID_t::kOutsideDrift_Partial;
           break; // If one hit is out of time it must be a cosmic ray
@@ -234,7 +239,8 @@ void cosmic::CosmicPCAxisTagger::produce(art::Event& evt)
     }
 
     // Recover the space points associated to this PFParticle.
-    std::vector<art::Ptr<recob::SpacePoint>> spacePointVec = spacePointAssnVec.at(pfParticle.key());
+    const std::vector<art::Ptr<recob::SpacePoint>>& spacePointVec =
+      spacePointAssnVec.at(pfParticle.key());
 
     /////////////////////////////////
     // Now check the TPC boundaries:
@@ -254,23 +260,33 @@ void cosmic::CosmicPCAxisTagger::produce(art::Event& evt)
         // the principle axis. Set up to do that
         double arcLengthToFirstHit(9999.);
         double arcLengthToLastHit(-9999.);
+        const double* firstHitPos(nullptr);
+        const double* lastHitPos(nullptr);
+
+        // Both extremes come out of a single pass, the positions are only copied at the end
+        const double vtxX(vertexPosition.X()), vtxY(vertexPosition.Y()), vtxZ(vertexPosition.Z());
+        const double dirX(vertexDirection.X()), dirY(vertexDirection.Y()),
+          dirZ(vertexDirection.Z());
 
-        for (const auto spacePoint : spacePointVec) {
-          TVector3 spacePointPos(spacePoint->XYZ()[0], spacePoint->XYZ()[1], spacePoint->XYZ()[2]);
-          TVector3 deltaPos = spacePointPos - vertexPosition;
-          double arcLenToHit = deltaPos.Dot(vertexDirection);
+        for (const auto& spacePoint : spacePointVec) {
+          const double* xyz = spacePoint->XYZ();
+          double arcLenToHit =
+            (xyz[0] - vtxX) * dirX + (xyz[1] - vtxY) * dirY + (xyz[2] - vtxZ) * dirZ;
 
           if (arcLenToHit < arcLengthToFirstHit) {
             arcLengthToFirstHit = arcLenToHit;
-            pcAxisStart = spacePointPos;
+            firstHitPos = xyz;
           }
 
           if (arcLenToHit > arcLengthToLastHit) {
             arcLengthToLastHit = arcLenToHit;
-            pcAxisEnd = spacePointPos;
+            lastHitPos = xyz;
           }
         }
 
+        if (firstHitPos) pcAxisStart.SetXYZ(firstHitPos[0], firstHitPos[1], firstHitPos[2]);
+        if (lastHitPos) pcAxisEnd.SetXYZ(lastHitPos[0], lastHitPos[1], lastHitPos[2]);
+
         // "Track" end points in easily readable form
         trackEndPt1_X = pcAxisStart[0];
         trackEndPt1_Y = pcAxisStart[1];
@@ -156,8 +156,6 @@ void cosmic::CosmicPFParticleTagger::produce(art::Event& evt)
     anab::CosmicTagID_t tag_id = anab::CosmicTagID_t::kNotTagged;
     art::Ptr<recob::Track> track1 = trackVec.front();
 
-    std::vector<art::Ptr<recob::Hit>> hitVec = hitsSpill.at(track1.key());
-
     // Recover track end points
     auto vertexPosition = track1->Vertex();
     auto vertexDirection = track1->VertexDirection();
@@ -169,7 +167,7 @@ void cosmic::CosmicPFParticleTagger::produce(art::Event& evt)
     // associated to the single PFParticle
     if (trackVec.size() > 1) {
       for (size_t trackIdx = 1; trackIdx < trackVec.size(); trackIdx++) {
-        art::Ptr<recob::Track> track(trackVec[trackIdx]);
+        const art::Ptr<recob::Track>& track(trackVec[trackIdx]);
 
         auto trackStart = track->Vertex();
         auto trackEnd = track->End();
@@ -195,10 +193,6 @@ void cosmic::CosmicPFParticleTagger::produce(art::Event& evt)
           else
             endPosition = trackEnd;
         }
-
-        // add the hits from this track to the collection
-        hitVec.insert(
-          hitVec.end(), hitsSpill.at(track.key()).begin(), hitsSpill.at(track.key()).end());
       }
     }
 
@@ -213,19 +207,24 @@ void cosmic::CosmicPFParticleTagger::produce(art::Event& evt)
     /////////////////////////////////////
     // Check that all hits on particle are "in time"
     /////////////////////////////////////
+    // The hits of all the tracks are counted in place, in a single pass
     int nOutOfTime(0);
 
-    for (unsigned int p = 0; p < hitVec.size(); p++) {
-      int peakLessRms = hitVec[p]->PeakTimeMinusRMS();
-      int peakPlusRms = hitVec[p]->PeakTimePlusRMS();
-
-      if (peakLessRms < fMinTickDrift || peakPlusRms > fMaxTickDrift) {
-        if (++nOutOfTime > fMaxOutOfTime) {
-          isCosmic = 1;
-          tag_id = anab::CosmicTagID_t::kOutsideDrift_Partial;
-          break; // If one hit is out of time it must be a cosmic ray
+    for (const auto& track : trackVec) {
+      for (const auto& hit : hitsSpill.at(track.key())) {
+        int peakLessRms = hit->PeakTimeMinusRMS();
+        int peakPlusRms = hit->PeakTimePlusRMS();
+
+        if (peakLessRms < fMinTickDrift || peakPlusRms > fMaxTickDrift) {
+          if (++nOutOfTime > fMaxOutOfTime) {
+            isCosmic = 1;
+            tag_id = anab::CosmicTagID_t::kOutsideDrift_Partial;
+            break; // If one hit is out of time it must be a cosmic ray
+          }
         }
       }
+
+      if (isCosmic != 0) break;
     }
 
     /////////////////////////////////
@@ -14,7 +14,9 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "canvas/Persistency/Common/FindManyP.h"
 
+#include <cstddef>
 #include <iostream>
+#include <vector>
 
 #include "larcore/CoreUtils/ServiceUtil.h"
 #include "larcore/Geometry/Geometry.h"
@@ -32,6 +34,17 @@ namespace cosmic {
   class CosmicTrackTagger;
 }
 
+namespace {
+  // end points of a tagged track, used to find the tagged track nearest to a stub
+  struct TaggedSegment {
+    recob::tracking::Point_t start;
+    recob::tracking::Point_t end;
+    double length; ///< distance between start and end
+    float score;
+    anab::CosmicTagID_t type;
+  };
+}
+
 class cosmic::CosmicTrackTagger : public art::EDProducer {
 public:
   explicit CosmicTrackTagger(fhicl::ParameterSet const& p);
@@ -234,48 +247,56 @@ void cosmic::CosmicTrackTagger::produce(art::Event& e)
   ///////////////////////////////////////////////////////////////////////////////////////////////
   //////TAGGING DELTA RAYS (and other stub) ASSOCIATED TO A ALREADY TAGGED COSMIC TRACK//////////
   ///////////////////////////////////////////////////////////////////////////////////////////////
+  // Pack the segments of the tagged tracks once; the scores given below are never 1 or 0.5,
+  // so the set of tagged tracks does not change while the stubs are being tagged
+  std::vector<TaggedSegment> taggedSegments;
+
+  for (unsigned int iTrk1 = 0; iTrk1 < Trk_h->size(); iTrk1++) {
+    float getScore = (*cosmicTagTrackVector)[iTrk1].CosmicScore();
+    if (getScore == 1 || getScore == 0.5) {
+      recob::Track const& tTrk1 = (*Trk_h)[iTrk1];
+      taggedSegments.push_back({tTrk1.Vertex(),
+                                tTrk1.End(),
+                                (tTrk1.End() - tTrk1.Vertex()).R(),
+                                getScore,
+                                (*cosmicTagTrackVector)[iTrk1].CosmicType()});
+    }
+  }
+
   float dE = 0, dS = 0, temp = 0, IScore = 0;
-  unsigned int IndexE = 0, iTrk1 = 0, iTrk = 0;
+  std::size_t IndexE = 0;
   anab::CosmicTagID_t IType = anab::CosmicTagID_t::kNotTagged;
+  // without any tagged track the stubs are compared to the first track, as it has always been
+  recob::tracking::Point_t tStartI, tEndI;
+  if (!Trk_h->empty()) {
+    tStartI = Trk_h->front().Vertex();
+    tEndI = Trk_h->front().End();
+  }
 
-  for (iTrk = 0; iTrk < Trk_h->size(); iTrk++) {
-    art::Ptr<recob::Track> tTrk = TrkVec.at(iTrk);
+  for (unsigned int iTrk = 0; iTrk < Trk_h->size(); iTrk++) {
+    recob::Track const& tTrk = (*Trk_h)[iTrk];
     if ((*cosmicTagTrackVector)[iTrk].CosmicScore() == 0) {
-      auto tStart = tTrk->Vertex();
-      auto tEnd = tTrk->End();
-      unsigned int l = 0;
-      for (iTrk1 = 0; iTrk1 < Trk_h->size(); iTrk1++) {
-        art::Ptr<recob::Track> tTrk1 = TrkVec.at(iTrk1);
-        float getScore = (*cosmicTagTrackVector)[iTrk1].CosmicScore();
-        if (getScore == 1 || getScore == 0.5) {
-          anab::CosmicTagID_t getType = (*cosmicTagTrackVector)[iTrk1].CosmicType();
-          auto tStart1 = tTrk1->Vertex();
-          auto tEnd1 = tTrk1->End();
-          auto NumE = (tEnd - tStart1).Cross(tEnd - tEnd1);
-          auto DenE = tEnd1 - tStart1;
-          dE = NumE.R() / DenE.R();
-          if (l == 0) {
-            temp = dE;
-            IndexE = iTrk1;
-            IScore = getScore;
-            IType = getType;
-          }
-          if (dE < temp) {
-            temp = dE;
-            IndexE = iTrk1;
-            IScore = getScore;
-            IType = getType;
-          }
-          l++;
+      auto tStart = tTrk.Vertex();
+      auto tEnd = tTrk.End();
+      for (std::size_t iSeg = 0; iSeg < taggedSegments.size(); iSeg++) {
+        TaggedSegment const& seg = taggedSegments[iSeg];
+        auto NumE = (tEnd - seg.start).Cross(tEnd - seg.end);
+        dE = NumE.R() / seg.length;
+        if (iSeg == 0 || dE < temp) {
+          temp = dE;
+          IndexE = iSeg;
+          IScore = seg.score;
+          IType = seg.type;
         }
       } //End Trk1 loop
-      art::Ptr<recob::Track> tTrkI = TrkVec.at(IndexE);
-      auto tStartI = tTrkI->Vertex();
-      auto tEndI = tTrkI->End();
+      if (!taggedSegments.empty()) {
+        tStartI = taggedSegments[IndexE].start;
+        tEndI = taggedSegments[IndexE].end;
+      }
       auto NumS = (tStart - tStartI).Cross(tStart - tEndI);
       auto DenS = tEndI - tStartI;
       dS = NumS.R() / DenS.R();
-      if (((dS < 5 && temp < 5) || (dS < temp && dS < 5)) && (tTrk->Length() < 60)) {
+      if (((dS < 5 && temp < 5) || (dS < temp && dS < 5)) && (tTrk.Length() < 60)) {
         (*cosmicTagTrackVector)[iTrk].CosmicScore() = IScore - 0.05;
         (*cosmicTagTrackVector)[iTrk].CosmicType() = IType;
       }
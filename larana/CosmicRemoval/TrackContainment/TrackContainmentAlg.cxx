@@ -3,7 +3,11 @@
 #include "fhiclcpp/ParameterSet.h"
 #include "larcorealg/Geometry/GeometryCore.h"
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <iostream>
+#include <utility>
 
 #include "TTree.h"
 
@@ -117,41 +121,6 @@ anab::CosmicTagID_t trk::TrackContainmentAlg::GetCosmicTagID(recob::Track const&
   return id;
 }
 
-double trk::TrackContainmentAlg::MinDistanceStartPt(recob::Track const& t_probe,
-                                                    recob::Track const& t_ref)
-{
-  double min_distance = 9e12;
-  double tmp;
-  for (size_t i_p = 0; i_p < t_ref.NumberTrajectoryPoints(); ++i_p) {
-    tmp = (t_probe.Vertex().X() - t_ref.LocationAtPoint(i_p).X()) *
-            (t_probe.Vertex().X() - t_ref.LocationAtPoint(i_p).X()) +
-          (t_probe.Vertex().Y() - t_ref.LocationAtPoint(i_p).Y()) *
-            (t_probe.Vertex().Y() - t_ref.LocationAtPoint(i_p).Y()) +
-          (t_probe.Vertex().Z() - t_ref.LocationAtPoint(i_p).Z()) *
-            (t_probe.Vertex().Z() - t_ref.LocationAtPoint(i_p).Z());
-    //std::cout << "\t\t\ttmp=" << tmp << std::endl;
-    if (tmp < min_distance) min_distance = tmp;
-  }
-  return std::sqrt(min_distance);
-}
-
-double trk::TrackContainmentAlg::MinDistanceEndPt(recob::Track const& t_probe,
-                                                  recob::Track const& t_ref)
-{
-  double min_distance = 9e12;
-  double tmp;
-  for (size_t i_p = 0; i_p < t_ref.NumberTrajectoryPoints(); ++i_p) {
-    tmp = (t_probe.End().X() - t_ref.LocationAtPoint(i_p).X()) *
-            (t_probe.End().X() - t_ref.LocationAtPoint(i_p).X()) +
-          (t_probe.End().Y() - t_ref.LocationAtPoint(i_p).Y()) *
-            (t_probe.End().Y() - t_ref.LocationAtPoint(i_p).Y()) +
-          (t_probe.End().Z() - t_ref.LocationAtPoint(i_p).Z()) *
-            (t_probe.End().Z() - t_ref.LocationAtPoint(i_p).Z());
-    if (tmp < min_distance) min_distance = tmp;
-  }
-  return std::sqrt(min_distance);
-}
-
 void trk::TrackContainmentAlg::SetRunEvent(unsigned int const& run, unsigned int const& event)
 {
   fRun = run;
@@ -174,98 +143,118 @@ void trk::TrackContainmentAlg::ProcessTracks(
               << std::endl;
   }
 
-  int containment_level = 0;
-  bool track_linked = false;
-  std::size_t n_tracks = 0;
-
   fTrackContainmentLevel.clear();
   fTrackContainmentLevel.resize(tracksVec.size());
   fMinDistances.clear();
   fMinDistances.resize(tracksVec.size());
 
-  fTrackContainmentIndices.clear();
-  fTrackContainmentIndices.push_back(std::vector<std::pair<int, int>>());
-
   fCosmicTags.clear();
   fCosmicTags.resize(tracksVec.size());
 
+  //flat index of every track, and its containment level (-1 if not linked)
+  std::vector<std::pair<size_t, size_t>> track_indices;
+  std::vector<int> levels;
+
   //first, loop through tracks and see what's not contained
+  //these seed the containment levels
+  std::deque<size_t> to_visit;
 
   for (size_t i_tc = 0; i_tc < tracksVec.size(); ++i_tc) {
     fTrackContainmentLevel[i_tc].resize(tracksVec[i_tc].size(), -1);
     fMinDistances[i_tc].resize(tracksVec[i_tc].size(), 9e12);
     fCosmicTags[i_tc].resize(tracksVec[i_tc].size(), anab::CosmicTag(-1));
-    n_tracks += tracksVec[i_tc].size();
     for (size_t i_t = 0; i_t < tracksVec[i_tc].size(); ++i_t) {
 
+      levels.push_back(-1);
       if (!IsContained(tracksVec[i_tc][i_t], geo)) {
-        if (!track_linked) track_linked = true;
-        fTrackContainmentLevel[i_tc][i_t] = 0;
-        fTrackContainmentIndices.back().emplace_back(i_tc, i_t);
+        levels.back() = 0;
+        to_visit.push_back(track_indices.size());
         if (fDebug) {
           std::cout << "\tTrack (" << i_tc << "," << i_t << ")"
-                    << " " << containment_level << std::endl;
+                    << " " << 0 << std::endl;
         }
 
       } //end if contained
-    }   //end loop over tracks
+      track_indices.emplace_back(i_tc, i_t);
+    } //end loop over tracks
 
   } //end loop over track collections
 
-  //now, while we are still linking tracks, loop over all tracks and note anything
-  //close to an uncontained (or linked) track
-  while (track_linked) {
-
-    track_linked = false;
-    ++containment_level;
-    fTrackContainmentIndices.push_back(std::vector<std::pair<int, int>>());
-
-    for (size_t i_tc = 0; i_tc < tracksVec.size(); ++i_tc) {
-      for (size_t i_t = 0; i_t < tracksVec[i_tc].size(); ++i_t) {
-        if (fTrackContainmentLevel[i_tc][i_t] >= 0)
-          continue;
-        else {
-          for (auto const& i_tr : fTrackContainmentIndices[containment_level - 1]) {
-
-            /*
-              if(fDebug){
-                std::cout << "\t\t" << MinDistanceStartPt(tracksVec[i_tc][i_t],tracksVec[i_tr.first][i_tr.second]) << std::endl;
-                std::cout << "\t\t" << MinDistanceEndPt(tracksVec[i_tc][i_t],tracksVec[i_tr.first][i_tr.second]) << std::endl;
-              }
-              */
-
-            if (MinDistanceStartPt(tracksVec[i_tc][i_t], tracksVec[i_tr.first][i_tr.second]) <
-                fMinDistances[i_tc][i_t])
-              fMinDistances[i_tc][i_t] =
-                MinDistanceStartPt(tracksVec[i_tc][i_t], tracksVec[i_tr.first][i_tr.second]);
-            if (MinDistanceEndPt(tracksVec[i_tc][i_t], tracksVec[i_tr.first][i_tr.second]) <
-                fMinDistances[i_tc][i_t])
-              fMinDistances[i_tc][i_t] =
-                MinDistanceEndPt(tracksVec[i_tc][i_t], tracksVec[i_tr.first][i_tr.second]);
-
-            if (MinDistanceStartPt(tracksVec[i_tc][i_t], tracksVec[i_tr.first][i_tr.second]) <
-                  fIsolation ||
-                MinDistanceEndPt(tracksVec[i_tc][i_t], tracksVec[i_tr.first][i_tr.second]) <
-                  fIsolation) {
-              if (!track_linked) track_linked = true;
-              fTrackContainmentLevel[i_tc][i_t] = containment_level;
-              fTrackContainmentIndices.back().emplace_back(i_tc, i_t);
-
-              if (fDebug) {
-                std::cout << "\tTrackPair (" << i_tc << "," << i_t << ") and (" << i_tr.first << ","
-                          << i_tr.second << ")"
-                          << " " << containment_level << std::endl;
-              }
-
-            } //end if track not isolated
-
-          } //end loop over existing uncontained/linked tracks
-
-        } //end if track not already linked
-
-      } //end loops over tracks
-    }   //end loop over track collections
-  }     //end while linking tracks
+  //index the trajectory points of all tracks once for the event
+  fPointIndex.Clear();
+  size_t n_points = 0;
+  for (auto const& [i_tc, i_t] : track_indices)
+    n_points += tracksVec[i_tc][i_t].NumberTrajectoryPoints();
+  fPointIndex.Reserve(n_points);
+  for (size_t i_track = 0; i_track < track_indices.size(); ++i_track) {
+    auto const& [i_tc, i_t] = track_indices[i_track];
+    recob::Track const& track = tracksVec[i_tc][i_t];
+    for (size_t i_p = 0; i_p < track.NumberTrajectoryPoints(); ++i_p) {
+      auto const& loc = track.LocationAtPoint(i_p);
+      fPointIndex.Add(loc.X(), loc.Y(), loc.Z(), i_track);
+    }
+  }
+  fPointIndex.Build();
+
+  //build the links once: a track is linked to another if one of its end points is closer
+  //than the isolation distance to any trajectory point of the other
+  std::vector<std::vector<size_t>> linked_from(track_indices.size());
+  std::vector<size_t> last_probe(track_indices.size(), track_indices.size());
+  for (size_t i_track = 0; i_track < track_indices.size(); ++i_track) {
+    if (levels[i_track] == 0) continue;
+    auto const add_link = [&linked_from, &last_probe, i_track](size_t i_ref, double) {
+      if (i_ref == i_track || last_probe[i_ref] == i_track) return;
+      last_probe[i_ref] = i_track;
+      linked_from[i_ref].push_back(i_track);
+    };
+    auto const& [i_tc, i_t] = track_indices[i_track];
+    recob::Track const& track = tracksVec[i_tc][i_t];
+    fPointIndex.ForEachWithin(
+      track.Vertex().X(), track.Vertex().Y(), track.Vertex().Z(), fIsolation, add_link);
+    fPointIndex.ForEachWithin(
+      track.End().X(), track.End().Y(), track.End().Z(), fIsolation, add_link);
+  }
+
+  //the containment level of a track is its number of links from the closest uncontained track
+  while (!to_visit.empty()) {
+    size_t const i_ref = to_visit.front();
+    to_visit.pop_front();
+    for (size_t const i_track : linked_from[i_ref]) {
+      if (levels[i_track] >= 0) continue;
+      levels[i_track] = levels[i_ref] + 1;
+      to_visit.push_back(i_track);
+
+      if (fDebug) {
+        std::cout << "\tTrackPair (" << track_indices[i_track].first << ","
+                  << track_indices[i_track].second << ") and (" << track_indices[i_ref].first
+                  << "," << track_indices[i_ref].second << ")"
+                  << " " << levels[i_track] << std::endl;
+      }
+    }
+  }
+
+  //the minimum distance of a track is taken to all the tracks of lower containment level,
+  //or to all the linked tracks if the track is not linked itself
+  bool const any_linked = std::find(levels.begin(), levels.end(), 0) != levels.end();
+  for (size_t i_track = 0; i_track < track_indices.size(); ++i_track) {
+    auto const [i_tc, i_t] = track_indices[i_track];
+    int const level = levels[i_track];
+    fTrackContainmentLevel[i_tc][i_t] = level;
+    if (level == 0 || !any_linked) continue;
+
+    auto const closer_to_seeds = [&levels, level](size_t i_ref) {
+      return levels[i_ref] >= 0 && (level < 0 || levels[i_ref] < level);
+    };
+    auto const& vertex = tracksVec[i_tc][i_t].Vertex();
+    auto const& end = tracksVec[i_tc][i_t].End();
+    double const start_distance = std::sqrt(
+      fPointIndex.NearestDistance2(vertex.X(), vertex.Y(), vertex.Z(), closer_to_seeds, 9e12));
+    double const end_distance =
+      std::sqrt(fPointIndex.NearestDistance2(end.X(), end.Y(), end.Z(), closer_to_seeds, 9e12));
+
+    if (start_distance < fMinDistances[i_tc][i_t]) fMinDistances[i_tc][i_t] = start_distance;
+    if (end_distance < fMinDistances[i_tc][i_t]) fMinDistances[i_tc][i_t] = end_distance;
+  }
 
   if (fDebug) std::cout << "All done! Now let's make the tree and tags!" << std::endl;
 
@@ -18,6 +18,8 @@ namespace fhicl {
 #include "lardataobj/AnalysisBase/CosmicTag.h"
 #include "lardataobj/RecoBase/Track.h"
 
+#include "TrajectoryPointIndex.hh"
+
 class TTree;
 
 namespace geo {
@@ -111,15 +113,14 @@ private:
   int fContainment;
 
   std::vector<std::vector<int>> fTrackContainmentLevel;
-  std::vector<std::vector<std::pair<int, int>>> fTrackContainmentIndices;
   std::vector<std::vector<double>> fMinDistances;
   std::vector<std::vector<anab::CosmicTag>> fCosmicTags;
 
   bool IsContained(recob::Track const&, geo::GeometryCore const&);
   anab::CosmicTagID_t GetCosmicTagID(recob::Track const&, geo::GeometryCore const&);
 
-  double MinDistanceStartPt(recob::Track const&, recob::Track const&);
-  double MinDistanceEndPt(recob::Track const&, recob::Track const&);
+  /// Trajectory points of all the tracks of the event, labelled by their flat track index
+  TrajectoryPointIndex fPointIndex;
 };
 
 #endif
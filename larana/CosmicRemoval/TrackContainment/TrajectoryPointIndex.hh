@@ -0,0 +1,133 @@
+/**
+ * \file TrajectoryPointIndex.hh
+ *
+ * \brief k-d tree over the trajectory points of a set of tracks
+ *
+ * Each point carries the index of the track it belongs to, so that
+ * nearest-point queries can be restricted to a subset of the tracks.
+ * Distances are computed with the same arithmetic as a brute-force scan,
+ * so the results are identical to it, not just close.
+ */
+
+#ifndef TRK_TRAJECTORYPOINTINDEX_H
+#define TRK_TRAJECTORYPOINTINDEX_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace trk {
+
+  class TrajectoryPointIndex {
+
+  public:
+    struct Point_t {
+      std::array<double, 3> pos;
+      std::size_t track;
+    };
+
+    void Clear() { fPoints.clear(); }
+    void Reserve(std::size_t n) { fPoints.reserve(n); }
+    void Add(double x, double y, double z, std::size_t track)
+    {
+      fPoints.push_back(Point_t{{x, y, z}, track});
+    }
+
+    /// Arranges the points in the tree; call after adding them and before any query
+    void Build() { Build(0, fPoints.size(), 0); }
+
+    std::size_t size() const { return fPoints.size(); }
+
+    /**
+       @brief Smallest squared distance from (x,y,z) to a point of an accepted track
+       @input accept -> predicate on the track index of the points to consider
+       @input best -> returned if no accepted point is strictly closer than this
+     */
+    template <typename Accept>
+    double NearestDistance2(double x, double y, double z, Accept accept, double best) const
+    {
+      Nearest({x, y, z}, accept, 0, fPoints.size(), 0, best);
+      return best;
+    }
+
+    /**
+       @brief Calls f(track, distance) for each point closer than radius to (x,y,z)
+       A point is reported when std::sqrt of its squared distance is below radius.
+     */
+    template <typename Visit>
+    void ForEachWithin(double x, double y, double z, double radius, Visit f) const
+    {
+      Within({x, y, z}, radius, f, 0, fPoints.size(), 0);
+    }
+
+  private:
+    std::vector<Point_t> fPoints;
+
+    static double Distance2(std::array<double, 3> const& p, std::array<double, 3> const& q)
+    {
+      return (p[0] - q[0]) * (p[0] - q[0]) + (p[1] - q[1]) * (p[1] - q[1]) +
+             (p[2] - q[2]) * (p[2] - q[2]);
+    }
+
+    // the node of [lo,hi) is its median element, splitting on axis depth%3
+    void Build(std::size_t lo, std::size_t hi, unsigned int depth)
+    {
+      if (hi - lo < 2) return;
+      std::size_t const mid = lo + (hi - lo) / 2;
+      unsigned int const axis = depth % 3;
+      auto const byAxis = [axis](Point_t const& a, Point_t const& b) {
+        return a.pos[axis] < b.pos[axis];
+      };
+      std::nth_element(fPoints.begin() + lo, fPoints.begin() + mid, fPoints.begin() + hi, byAxis);
+      Build(lo, mid, depth + 1);
+      Build(mid + 1, hi, depth + 1);
+    }
+
+    template <typename Accept>
+    void Nearest(std::array<double, 3> const& p,
+                 Accept& accept,
+                 std::size_t lo,
+                 std::size_t hi,
+                 unsigned int depth,
+                 double& best) const
+    {
+      if (lo >= hi) return;
+      std::size_t const mid = lo + (hi - lo) / 2;
+      Point_t const& node = fPoints[mid];
+      if (accept(node.track)) best = std::min(best, Distance2(p, node.pos));
+
+      double const diff = p[depth % 3] - node.pos[depth % 3];
+      bool const left = diff < 0;
+      Nearest(p, accept, left ? lo : mid + 1, left ? mid : hi, depth + 1, best);
+      // points beyond the splitting plane are at least diff away
+      if (diff * diff < best)
+        Nearest(p, accept, left ? mid + 1 : lo, left ? hi : mid, depth + 1, best);
+    }
+
+    template <typename Visit>
+    void Within(std::array<double, 3> const& p,
+                double radius,
+                Visit& f,
+                std::size_t lo,
+                std::size_t hi,
+                unsigned int depth) const
+    {
+      if (lo >= hi) return;
+      std::size_t const mid = lo + (hi - lo) / 2;
+      Point_t const& node = fPoints[mid];
+      double const d = std::sqrt(Distance2(p, node.pos));
+      if (d < radius) f(node.track, d);
+
+      double const diff = p[depth % 3] - node.pos[depth % 3];
+      bool const left = diff < 0;
+      Within(p, radius, f, left ? lo : mid + 1, left ? mid : hi, depth + 1);
+      if (std::sqrt(diff * diff) < radius)
+        Within(p, radius, f, left ? mid + 1 : lo, left ? hi : mid, depth + 1);
+    }
+  };
+
+}
+
+#endif
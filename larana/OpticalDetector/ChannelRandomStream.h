@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////
+// \file ChannelRandomStream.h
+//
+// \brief per-channel random number streams for the optical digitizers
+//
+// Each optical channel of an event draws from its own stream, picked by
+// seeding a MixMax engine with the event key, the channel number and the
+// purpose of the numbers. MixMax gives statistically independent streams
+// for distinct seeds, so what a channel draws does not depend on the
+// order (or the thread) in which the channels are digitized.
+//
+// The 64-bit event key fills two of the four 32-bit seed words, so that
+// distinct events practically never share their streams; the channel and
+// the purpose fill the other two.
+//
+////////////////////////////////////////////////////////////////////////
+
+#ifndef OPDET_CHANNELRANDOMSTREAM_H
+#define OPDET_CHANNELRANDOMSTREAM_H
+
+#include "CLHEP/Random/MixMaxRng.h"
+
+#include <cstdint>
+
+namespace opdet {
+
+  class ChannelRandomStream {
+  public:
+    /// Draws the key of this event's streams from the module engine
+    static std::uint64_t EventKey(CLHEP::HepRandomEngine& engine)
+    {
+      std::uint64_t const high = static_cast<unsigned int>(engine);
+      std::uint64_t const low = static_cast<unsigned int>(engine);
+      return (high << 32) | low;
+    }
+
+    /// Restarts the engine on the stream of a channel, for the event with the given key
+    void Select(std::uint64_t eventKey, std::uint32_t channel, std::uint32_t purpose = 0)
+    {
+      fSeeds[0] = eventKey >> 32;
+      fSeeds[1] = eventKey & 0xFFFFFFFF;
+      fSeeds[2] = channel;
+      // the top bit keeps the seeds from ever being all zero
+      fSeeds[3] = purpose | 0x80000000;
+      fEngine.setSeeds(fSeeds, 4);
+    }
+
+    CLHEP::HepRandomEngine& Engine() noexcept { return fEngine; }
+
+  private:
+    long fSeeds[4] = {0, 0, 0, 0x80000000}; // the engine keeps a pointer to them
+    CLHEP::MixMaxRng fEngine;
+  };
+
+} // namespace opdet
+
+#endif
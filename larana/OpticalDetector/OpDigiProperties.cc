@@ -143,6 +143,18 @@ namespace opdet {
     return CLHEP::RandGauss::shoot(fHighGainArray[ch], fGainSpreadArray[ch] * fHighGainArray[ch]);
   }
   //--------------------------------------------------------------------
+  double OpDigiProperties::LowGain(optdata::Channel_t ch, CLHEP::HepRandomEngine& engine) const
+  {
+    return CLHEP::RandGauss::shoot(
+      &engine, fLowGainArray[ch], fGainSpreadArray[ch] * fLowGainArray[ch]);
+  }
+  //--------------------------------------------------------------------
+  double OpDigiProperties::HighGain(optdata::Channel_t ch, CLHEP::HepRandomEngine& engine) const
+  {
+    return CLHEP::RandGauss::shoot(
+      &engine, fHighGainArray[ch], fGainSpreadArray[ch] * fHighGainArray[ch]);
+  }
+  //--------------------------------------------------------------------
   optdata::TimeSlice_t OpDigiProperties::GetTimeSlice(double time_ns)
   {
     if (time_ns / 1.e3 > (fTimeEnd - fTimeBegin))
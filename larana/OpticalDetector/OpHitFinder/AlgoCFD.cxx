@@ -9,10 +9,40 @@
 
 #include "fhiclcpp/ParameterSet.h"
 
-#include <unordered_map>
+#include <algorithm>
 
 namespace pmtana {
 
+  namespace {
+
+    // Among the pulses sharing the same key, keep the first one of largest width.
+    // The pulses are left sorted by key.
+    template <typename Key>
+    void KeepWidestPulses(pulse_param_array& pulses, Key key)
+    {
+      std::stable_sort(
+        pulses.begin(), pulses.end(), [&key](const pulse_param& a, const pulse_param& b) {
+          return key(a) < key(b);
+        });
+
+      auto out = pulses.begin();
+
+      for (auto it = pulses.begin(); it != pulses.end();) {
+        auto widest = it;
+        auto next = it + 1;
+
+        for (; next != pulses.end() && key(*next) == key(*it); ++next)
+          if ((next->t_end - next->t_start) > (widest->t_end - widest->t_start)) widest = next;
+
+        *out++ = *widest;
+        it = next;
+      }
+
+      pulses.erase(out, pulses.end());
+    }
+
+  }
+
   //*********************************************************************
   AlgoCFD::AlgoCFD(const std::string name) : PMTPulseRecoBase(name)
   //*********************************************************************
@@ -53,40 +83,37 @@ namespace pmtana {
                           const pmtana::PedestalSigma_t& sigma_v)
   //***************************************************************
   {
+    return FindPulses(wf, PedestalArrays{mean_v, sigma_v});
+  }
 
-    Reset();
-
-    std::vector<double> cfd;
-    cfd.reserve(wf.size());
-
-    // follow cfd procedure: invert waveform, multiply by constant fraction
-    // add to delayed waveform.
-    for (unsigned int k = 0; k < wf.size(); ++k) {
-
-      auto delayed = -1.0 * _F * ((float)wf.at(k) - mean_v.at(k));
-
-      if ((int)k < _D)
-
-        cfd.push_back(delayed);
-
-      else
+  //***************************************************************
+  bool AlgoCFD::RecoFlatPulse(const pmtana::Waveform_t& wf, double ped_mean, double ped_sigma)
+  //***************************************************************
+  {
+    return FindPulses(wf, FlatPedestal{ped_mean, ped_sigma});
+  }
 
-        cfd.push_back(delayed + ((float)wf.at(k - _D) - mean_v.at(k)));
-    }
+  //***************************************************************
+  template <typename Pedestal>
+  bool AlgoCFD::FindPulses(const pmtana::Waveform_t& wf, const Pedestal& ped)
+  //***************************************************************
+  {
 
-    // Get the zero point crossings, how can I tell which are meaningful?
-    // go to each crossing, see if waveform is above pedestal (high above pedestal)
+    Reset();
 
-    auto crossings = LinearZeroPointX(cfd);
+    // follow cfd procedure: invert waveform, multiply by constant fraction
+    // add to delayed waveform. The trace is streamed: each zero crossing
+    // is recorded as soon as the next cfd sample is known.
+    LinearZeroPointX(wf, ped, _crossings);
 
     // lambda criteria to determine if inside pulse
 
-    auto in_peak = [&wf, &sigma_v, &mean_v](int i, float thresh) -> bool {
-      return wf.at(i) > sigma_v.at(i) * thresh + mean_v.at(i);
+    auto in_peak = [&wf, &ped](int i, float thresh) -> bool {
+      return wf[i] > ped.Sigma(i) * thresh + ped.Mean(i);
     };
 
     // loop over CFD crossings
-    for (const auto& cross : crossings) {
+    for (const auto& cross : _crossings) {
 
       if (in_peak(cross.first, _peak_thresh)) {
         _pulse.reset_param();
@@ -154,13 +181,13 @@ namespace pmtana {
 
         //x
 
-        auto start_ped = mean_v.at(_pulse.t_start);
-        auto end_ped = mean_v.at(_pulse.t_end);
+        auto start_ped = ped.Mean(_pulse.t_start);
+        auto end_ped = ped.Mean(_pulse.t_end);
 
         //just take the "smaller one"
         _pulse.ped_mean = start_ped <= end_ped ? start_ped : end_ped;
 
-        if (wf.size() < 50) _pulse.ped_mean = mean_v.front(); //is COSMIC DISCRIMINATOR
+        if (wf.size() < 50) _pulse.ped_mean = ped.Mean(0); //is COSMIC DISCRIMINATOR
 
         auto it = std::max_element(std::begin(wf) + _pulse.t_start, std::begin(wf) + _pulse.t_end);
 
@@ -176,7 +203,7 @@ namespace pmtana {
         if (_risetime_calc_ptr)
           _pulse.t_rise = _risetime_calc_ptr->RiseTime(
             {wf.begin() + _pulse.t_start, wf.begin() + _pulse.t_end},
-            {mean_v.begin() + _pulse.t_start, mean_v.begin() + _pulse.t_end},
+            ped.MeanRange(_pulse.t_start, _pulse.t_end),
             true);
 
         _pulse_v.push_back(_pulse);
@@ -187,53 +214,15 @@ namespace pmtana {
     // Very close in time pulses have multiple CFD
     // crossing points. Should we check that pulses now have
     // some multiplicity? No lets just delete them.
-
-    auto pulses_copy = _pulse_v;
-    _pulse_v.clear();
-
-    std::unordered_map<unsigned, pulse_param> delta;
-
-    //unsigned width = 0;
-    for (const auto& p : pulses_copy) {
-
-      if (delta.count(p.t_start)) {
-        if ((p.t_end - p.t_start) > (delta[p.t_start].t_end - delta[p.t_start].t_start))
-          delta[p.t_start] = p;
-        else
-          continue;
-      }
-      else {
-        delta[p.t_start] = p;
-      }
-    }
-
-    for (const auto& p : delta)
-      _pulse_v.push_back(p.second);
+    KeepWidestPulses(_pulse_v, [](const pulse_param& p) { return p.t_start; });
 
     //do the same now ensure t_final's are all unique
-    //width = 0;
+    KeepWidestPulses(_pulse_v, [](const pulse_param& p) { return p.t_end; });
 
-    pulses_copy.clear();
-    pulses_copy = _pulse_v;
-
-    _pulse_v.clear();
-    delta.clear();
-
-    for (const auto& p : pulses_copy) {
-
-      if (delta.count(p.t_end)) {
-        if ((p.t_end - p.t_start) > (delta[p.t_end].t_end - delta[p.t_end].t_start))
-          delta[p.t_end] = p;
-        else
-          continue;
-      }
-      else {
-        delta[p.t_end] = p;
-      }
-    }
-
-    for (const auto& p : delta)
-      _pulse_v.push_back(p.second);
+    //the start ticks are still unique: hand the pulses out in start order
+    std::sort(_pulse_v.begin(), _pulse_v.end(), [](const pulse_param& a, const pulse_param& b) {
+      return a.t_start < b.t_start;
+    });
 
     //there should be no overlapping pulses now...
 
@@ -241,29 +230,36 @@ namespace pmtana {
   }
 
   // currently returns ALL zero point crossings, we really just want ones associated with peak...
-  const std::map<unsigned, double> AlgoCFD::LinearZeroPointX(const std::vector<double>& trace)
+  template <typename Pedestal>
+  void AlgoCFD::LinearZeroPointX(const pmtana::Waveform_t& wf,
+                                 const Pedestal& ped,
+                                 std::vector<std::pair<unsigned, double>>& crossing) const
   {
 
-    std::map<unsigned, double> crossing;
+    crossing.clear();
+
+    double prev = 0.;
 
     //step through the trace and find where slope is POSITIVE across zero
-    for (unsigned i = 0; i < trace.size() - 1; ++i) {
+    for (unsigned k = 0; k < wf.size(); ++k) {
 
-      auto si = ::pmtana::sign(trace.at(i));
-      auto sf = ::pmtana::sign(trace.at(i + 1));
+      double cfd = -1.0 * _F * ((float)wf[k] - ped.Mean(k));
 
-      if (si == sf) //no sign flip, no zero cross
-        continue;
+      if ((int)k >= _D) cfd += ((float)wf[k - _D] - ped.Mean(k));
 
-      if (sf < si) //this is a negative slope, continue
-        continue;
+      if (k > 0) {
 
-      //calculate the crossing X based on linear interpolation bt two pts
+        unsigned i = k - 1;
 
-      crossing[i] = (double)i - trace.at(i) * (1.0 / (trace.at(i + 1) - trace.at(i)));
-    }
+        //no sign flip, or a negative slope: no crossing
+        if (::pmtana::sign(prev) < ::pmtana::sign(cfd))
 
-    return crossing;
+          //calculate the crossing X based on linear interpolation bt two pts
+          crossing.emplace_back(i, (double)i - prev * (1.0 / (cfd - prev)));
+      }
+
+      prev = cfd;
+    }
   }
 
 }
@@ -23,8 +23,8 @@ namespace fhicl {
 
 #include "larana/OpticalDetector/OpHitFinder/OpticalRecoTypes.h"
 
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace pmtana {
@@ -54,9 +54,24 @@ namespace pmtana {
                    const pmtana::PedestalMean_t&,
                    const pmtana::PedestalSigma_t&);
 
-    const std::map<unsigned, double> LinearZeroPointX(const std::vector<double>& trace);
+    /// Implementation of AlgoCFD::reco() method for a flat pedestal
+    bool RecoFlatPulse(const pmtana::Waveform_t&, double ped_mean, double ped_sigma);
+
+    /// Fills crossing with the (index, interpolated position) of the positive slope
+    /// zero crossings of the CFD trace of the waveform, in increasing order
+    template <typename Pedestal>
+    void LinearZeroPointX(const pmtana::Waveform_t& wf,
+                          const Pedestal& ped,
+                          std::vector<std::pair<unsigned, double>>& crossing) const;
 
   private:
+    /// Pulse finding, for PedestalArrays or FlatPedestal
+    template <typename Pedestal>
+    bool FindPulses(const pmtana::Waveform_t& wf, const Pedestal& ped);
+
+    /// CFD crossings of the current waveform, kept to reuse the allocation
+    std::vector<std::pair<unsigned, double>> _crossings;
+
     float _F;
     int _D;
 
@@ -8,6 +8,8 @@
 
 #include "AlgoSlidingWindow.h"
 
+#include <algorithm>
+
 namespace pmtana {
 
   //*********************************************************************
@@ -63,6 +65,25 @@ namespace pmtana {
                                     const pmtana::PedestalMean_t& mean_v,
                                     const pmtana::PedestalSigma_t& sigma_v)
   //***************************************************************
+  {
+    assert(wf.size() == mean_v.size() && wf.size() == sigma_v.size());
+
+    return FindPulses(wf, PedestalArrays{mean_v, sigma_v});
+  }
+
+  //***************************************************************
+  bool AlgoSlidingWindow::RecoFlatPulse(const pmtana::Waveform_t& wf,
+                                        double ped_mean,
+                                        double ped_sigma)
+  //***************************************************************
+  {
+    return FindPulses(wf, FlatPedestal{ped_mean, ped_sigma});
+  }
+
+  //***************************************************************
+  template <typename Pedestal>
+  bool AlgoSlidingWindow::FindPulses(const pmtana::Waveform_t& wf, const Pedestal& ped)
+  //***************************************************************
   {
 
     bool fire = false;
@@ -79,36 +100,44 @@ namespace pmtana {
 
     int post_integration = 0;
 
-    assert(wf.size() == mean_v.size() && wf.size() == sigma_v.size());
-
     //double threshold = ( _adc_thres > (_nsigma * _ped_rms) ? _adc_thres : (_nsigma * _ped_rms) );
 
     //threshold += _ped_mean;
 
     Reset();
 
-    for (size_t i = 0; i < wf.size(); ++i) {
+    // Pre-pass: the signal above baseline and whether it passes the start threshold, for every
+    // sample. These loops carry no state so they can be vectorized.
+    const size_t nsamples = wf.size();
+
+    _value_v.resize(nsamples);
+    _above_start_v.resize(nsamples);
+
+    if (_positive) {
+      for (size_t i = 0; i < nsamples; ++i)
+        _value_v[i] = ((double)(wf[i])) - ped.Mean(i);
+    }
+    else {
+      for (size_t i = 0; i < nsamples; ++i)
+        _value_v[i] = ped.Mean(i) - ((double)(wf[i]));
+    }
+
+    for (size_t i = 0; i < nsamples; ++i)
+      _above_start_v[i] = _value_v[i] > StartThreshold(ped.Sigma(i));
 
-      double value = 0.;
-      if (_positive)
-        value = ((double)(wf[i])) - mean_v[i];
-      else
-        value = mean_v[i] - ((double)(wf[i]));
+    for (size_t i = 0; i < nsamples; ++i) {
 
-      float start_threshold = 0.;
-      float tail_threshold = 0.;
-      if (sigma_v[i] * _nsigma < _adc_thres)
-        start_threshold = _adc_thres;
-      else
-        start_threshold = sigma_v[i] * _nsigma;
+      // Outside of a pulse nothing happens until the start threshold is crossed
+      if (!fire && !in_tail && !in_post) {
+        i = std::find(_above_start_v.begin() + i, _above_start_v.end(), 1) -
+            _above_start_v.begin();
+        if (i == nsamples) break;
+      }
 
-      if (sigma_v[i] * _tail_nsigma < _tail_adc_thres)
-        tail_threshold = _tail_adc_thres;
-      else
-        tail_threshold = sigma_v[i] * _tail_nsigma;
+      const double value = _value_v[i];
 
       // End pulse if significantly high peak found (new pulse)
-      if ((!fire || in_tail || in_post) && ((double)value > start_threshold)) {
+      if ((!fire || in_tail || in_post) && _above_start_v[i]) {
 
         // If there's a pulse, end it
         if (in_tail) {
@@ -119,7 +148,7 @@ namespace pmtana {
             if (_risetime_calc_ptr)
               _pulse.t_rise = _risetime_calc_ptr->RiseTime(
                 {wf.begin() + _pulse.t_start, wf.begin() + _pulse.t_end},
-                {mean_v.begin() + _pulse.t_start, mean_v.begin() + _pulse.t_end},
+                ped.MeanRange(_pulse.t_start, _pulse.t_end),
                 _positive);
 
             _pulse_v.push_back(_pulse);
@@ -129,7 +158,7 @@ namespace pmtana {
 
           if (_verbose)
             std::cout << "\033[93mPulse End\033[00m: "
-                      << "baseline: " << mean_v[i] << " ... "
+                      << "baseline: " << ped.Mean(i) << " ... "
                       << " ... adc above: " << value << " T=" << i << std::endl;
         }
 
@@ -137,14 +166,17 @@ namespace pmtana {
         // Found a new pulse ... try to get a few samples prior to this
         //
 
-        pulse_tail_threshold = tail_threshold;
-        pulse_start_baseline = mean_v[i];
+        if (ped.Sigma(i) * _tail_nsigma < _tail_adc_thres)
+          pulse_tail_threshold = _tail_adc_thres;
+        else
+          pulse_tail_threshold = (float)(ped.Sigma(i) * _tail_nsigma);
+        pulse_start_baseline = ped.Mean(i);
 
         pulse_end_threshold = 0.;
-        if (sigma_v[i] * _end_nsigma < _end_adc_thres)
+        if (ped.Sigma(i) * _end_nsigma < _end_adc_thres)
           pulse_end_threshold = _end_adc_thres;
         else
-          pulse_end_threshold = sigma_v[i] * _end_nsigma;
+          pulse_end_threshold = ped.Sigma(i) * _end_nsigma;
 
         int buffer_num_index = 0;
         if (_pulse_v.size())
@@ -171,7 +203,7 @@ namespace pmtana {
             if (_risetime_calc_ptr)
               _pulse.t_rise = _risetime_calc_ptr->RiseTime(
                 {wf.begin() + _pulse.t_start, wf.begin() + _pulse.t_end},
-                {mean_v.begin() + _pulse.t_start, mean_v.begin() + _pulse.t_end},
+                ped.MeanRange(_pulse.t_start, _pulse.t_end),
                 _positive);
 
             _pulse_v.push_back(_pulse);
@@ -181,13 +213,13 @@ namespace pmtana {
 
           if (_verbose)
             std::cout << "\033[93mPulse End\033[00m: new pulse starts during in_post: "
-                      << "baseline: " << mean_v[i] << " ... "
+                      << "baseline: " << ped.Mean(i) << " ... "
                       << " ... adc above: " << value << " T=" << i << std::endl;
         }
 
         _pulse.t_start = i - buffer_num_index;
         _pulse.ped_mean = pulse_start_baseline;
-        _pulse.ped_sigma = sigma_v[i];
+        _pulse.ped_sigma = ped.Sigma(i);
 
         for (size_t pre_index = _pulse.t_start; pre_index < i; ++pre_index) {
 
@@ -202,7 +234,8 @@ namespace pmtana {
 
         if (_verbose)
           std::cout << "\033[93mPulse Start\033[00m: "
-                    << "baseline: " << mean_v[i] << " ... threshold: " << start_threshold
+                    << "baseline: " << ped.Mean(i)
+                    << " ... threshold: " << StartThreshold(ped.Sigma(i))
                     << " ... adc above baseline: " << value << " ... pre-adc sum: " << _pulse.area
                     << " T=" << i << std::endl;
 
@@ -217,12 +250,6 @@ namespace pmtana {
         in_post = false;
       }
 
-      if ((fire || in_tail || in_post) && _verbose) {
-        std::cout << (fire ? "\033[93mPulsing\033[00m: " : "\033[93mIn-tail\033[00m: ")
-                  << "baseline: " << mean_v[i] << " std: " << sigma_v[i]
-                  << " ... adc above baseline " << value << " T=" << i << std::endl;
-      }
-
       if ((fire || in_tail) && value < pulse_end_threshold) {
         in_post = true;
         fire = in_tail = false;
@@ -238,7 +265,7 @@ namespace pmtana {
           if (_risetime_calc_ptr)
             _pulse.t_rise = _risetime_calc_ptr->RiseTime(
               {wf.begin() + _pulse.t_start, wf.begin() + _pulse.t_end},
-              {mean_v.begin() + _pulse.t_start, mean_v.begin() + _pulse.t_end},
+              ped.MeanRange(_pulse.t_start, _pulse.t_end),
               _positive);
 
           _pulse_v.push_back(_pulse);
@@ -246,7 +273,7 @@ namespace pmtana {
 
         if (_verbose)
           std::cout << "\033[93mPulse End\033[00m: "
-                    << "baseline: " << mean_v[i] << " ... adc: " << value << " T=" << i
+                    << "baseline: " << ped.Mean(i) << " ... adc: " << value << " T=" << i
                     << " ... area sum " << _pulse.area << std::endl;
 
         _pulse.reset_param();
@@ -287,7 +314,7 @@ namespace pmtana {
         if (_risetime_calc_ptr)
           _pulse.t_rise = _risetime_calc_ptr->RiseTime(
             {wf.begin() + _pulse.t_start, wf.begin() + _pulse.t_end},
-            {mean_v.begin() + _pulse.t_start, mean_v.begin() + _pulse.t_end},
+            ped.MeanRange(_pulse.t_start, _pulse.t_end),
             _positive);
         _pulse_v.push_back(_pulse);
       }
@@ -23,6 +23,7 @@ namespace fhicl {
 #include "larana/OpticalDetector/OpHitFinder/OpticalRecoTypes.h"
 
 #include <string>
+#include <vector>
 
 namespace pmtana {
 
@@ -51,6 +52,9 @@ namespace pmtana {
                    const pmtana::PedestalMean_t&,
                    const pmtana::PedestalSigma_t&);
 
+    /// Implementation of AlgoSlidingWindow::reco() method for a flat pedestal
+    bool RecoFlatPulse(const pmtana::Waveform_t&, double ped_mean, double ped_sigma);
+
     /// A boolean to set waveform positive/negative polarity
     bool _positive;
 
@@ -64,6 +68,23 @@ namespace pmtana {
     float _nsigma, _tail_nsigma, _end_nsigma;
     bool _verbose;
     size_t _num_presample, _num_postsample;
+
+  private:
+    /// Pulse finding, for PedestalArrays or FlatPedestal
+    template <typename Pedestal>
+    bool FindPulses(const pmtana::Waveform_t& wf, const Pedestal& ped);
+
+    /// Threshold for a pulse to start, for a sample with pedestal standard deviation sigma
+    float StartThreshold(double sigma) const
+    {
+      return (sigma * _nsigma < _adc_thres) ? _adc_thres : (float)(sigma * _nsigma);
+    }
+
+    /// Signal above baseline of each sample of the current waveform
+    std::vector<double> _value_v;
+
+    /// Whether each sample of the current waveform passes the start threshold
+    std::vector<char> _above_start_v;
   };
 
 }
@@ -25,26 +25,76 @@
 #include <vector>
 
 namespace opdet {
-  //----------------------------------------------------------------------------
-  void RunHitFinder(std::vector<raw::OpDetWaveform> const& opDetWaveformVector,
-                    std::vector<recob::OpHit>& hitVector,
-                    pmtana::PulseRecoManager const& pulseRecoMgr,
-                    pmtana::PMTPulseRecoBase const& threshAlg,
-                    geo::GeometryCore const& geometry,
-                    float hitThreshold,
-                    detinfo::DetectorClocksData const& clocksData,
-                    calib::IPhotonCalibrator const& calibrator,
-                    bool use_start_time)
-  {
 
-    for (auto const& waveform : opDetWaveformVector) {
+  namespace {
+
+    // Quantities shared by all the hits from one waveform
+    struct WaveformHitContext {
+      int channel;
+      double timeStamp;
+      int frame;
+      double tickPeriod;
+      double triggerTime;
+      bool useArea;
+    };
+
+    void ConstructHit(float hitThreshold,
+                      WaveformHitContext const& context,
+                      pmtana::pulse_param const& pulse,
+                      std::vector<recob::OpHit>& hitVector,
+                      calib::IPhotonCalibrator const& calibrator,
+                      bool use_start_time)
+    {
+
+      if (pulse.peak < hitThreshold) return;
+
+      double absTime =
+        context.timeStamp + context.tickPeriod * (use_start_time ? pulse.t_start : pulse.t_max);
+
+      double relTime = absTime - context.triggerTime;
+
+      double startTime =
+        context.timeStamp + context.tickPeriod * pulse.t_start - context.triggerTime;
+
+      double riseTime = context.tickPeriod * pulse.t_rise;
+
+      double PE = 0.0;
+      if (context.useArea)
+        PE = calibrator.PE(pulse.area, context.channel);
+      else
+        PE = calibrator.PE(pulse.peak, context.channel);
+
+      double width = (pulse.t_end - pulse.t_start) * context.tickPeriod;
+
+      hitVector.emplace_back(context.channel,
+                             relTime,
+                             absTime,
+                             startTime,
+                             riseTime,
+                             context.frame,
+                             width,
+                             pulse.area,
+                             pulse.peak,
+                             PE,
+                             0.0);
+    }
 
+    void RunHitFinderOnWaveform(raw::OpDetWaveform const& waveform,
+                                std::vector<recob::OpHit>& hitVector,
+                                pmtana::PulseRecoManager const& pulseRecoMgr,
+                                pmtana::PMTPulseRecoBase const& threshAlg,
+                                geo::GeometryCore const& geometry,
+                                float hitThreshold,
+                                detinfo::DetectorClocksData const& clocksData,
+                                calib::IPhotonCalibrator const& calibrator,
+                                bool use_start_time)
+    {
       const int channel = static_cast<int>(waveform.ChannelNumber());
 
       if (!geometry.IsValidOpChannel(channel)) {
         mf::LogError("OpHitFinder")
           << "Error! unrecognized channel number " << channel << ". Ignoring pulse";
-        continue;
+        return;
       }
 
       pulseRecoMgr.Reconstruct(waveform);
@@ -54,16 +104,63 @@ namespace opdet {
 
       const double timeStamp = waveform.TimeStamp();
 
+      WaveformHitContext const context{channel,
+                                       timeStamp,
+                                       clocksData.OpticalClock().Frame(timeStamp),
+                                       clocksData.OpticalClock().TickPeriod(),
+                                       clocksData.TriggerTime(),
+                                       calibrator.UseArea()};
+
       for (auto const& pulse : pulses)
-        ConstructHit(hitThreshold,
-                     channel,
-                     timeStamp,
-                     pulse,
-                     hitVector,
-                     clocksData,
-                     calibrator,
-                     use_start_time);
+        ConstructHit(hitThreshold, context, pulse, hitVector, calibrator, use_start_time);
     }
+
+  }
+
+  //----------------------------------------------------------------------------
+  void RunHitFinder(std::vector<raw::OpDetWaveform> const& opDetWaveformVector,
+                    std::vector<recob::OpHit>& hitVector,
+                    pmtana::PulseRecoManager const& pulseRecoMgr,
+                    pmtana::PMTPulseRecoBase const& threshAlg,
+                    geo::GeometryCore const& geometry,
+                    float hitThreshold,
+                    detinfo::DetectorClocksData const& clocksData,
+                    calib::IPhotonCalibrator const& calibrator,
+                    bool use_start_time)
+  {
+    for (auto const& waveform : opDetWaveformVector)
+      RunHitFinderOnWaveform(waveform,
+                             hitVector,
+                             pulseRecoMgr,
+                             threshAlg,
+                             geometry,
+                             hitThreshold,
+                             clocksData,
+                             calibrator,
+                             use_start_time);
+  }
+
+  //----------------------------------------------------------------------------
+  void RunHitFinder(std::vector<raw::OpDetWaveform const*> const& opDetWaveformVector,
+                    std::vector<recob::OpHit>& hitVector,
+                    pmtana::PulseRecoManager const& pulseRecoMgr,
+                    pmtana::PMTPulseRecoBase const& threshAlg,
+                    geo::GeometryCore const& geometry,
+                    float hitThreshold,
+                    detinfo::DetectorClocksData const& clocksData,
+                    calib::IPhotonCalibrator const& calibrator,
+                    bool use_start_time)
+  {
+    for (auto const* waveform : opDetWaveformVector)
+      RunHitFinderOnWaveform(*waveform,
+                             hitVector,
+                             pulseRecoMgr,
+                             threshAlg,
+                             geometry,
+                             hitThreshold,
+                             clocksData,
+                             calibrator,
+                             use_start_time);
   }
 
   //----------------------------------------------------------------------------
@@ -76,40 +173,16 @@ namespace opdet {
                     calib::IPhotonCalibrator const& calibrator,
                     bool use_start_time)
   {
-
     if (pulse.peak < hitThreshold) return;
 
-    double absTime = timeStamp + clocksData.OpticalClock().TickPeriod() *
-                                   (use_start_time ? pulse.t_start : pulse.t_max);
-
-    double relTime = absTime - clocksData.TriggerTime();
-
-    double startTime =
-      timeStamp + clocksData.OpticalClock().TickPeriod() * pulse.t_start - clocksData.TriggerTime();
-
-    double riseTime = clocksData.OpticalClock().TickPeriod() * pulse.t_rise;
-
-    int frame = clocksData.OpticalClock().Frame(timeStamp);
-
-    double PE = 0.0;
-    if (calibrator.UseArea())
-      PE = calibrator.PE(pulse.area, channel);
-    else
-      PE = calibrator.PE(pulse.peak, channel);
-
-    double width = (pulse.t_end - pulse.t_start) * clocksData.OpticalClock().TickPeriod();
+    WaveformHitContext const context{channel,
+                                     timeStamp,
+                                     clocksData.OpticalClock().Frame(timeStamp),
+                                     clocksData.OpticalClock().TickPeriod(),
+                                     clocksData.TriggerTime(),
+                                     calibrator.UseArea()};
 
-    hitVector.emplace_back(channel,
-                           relTime,
-                           absTime,
-                           startTime,
-                           riseTime,
-                           frame,
-                           width,
-                           pulse.area,
-                           pulse.peak,
-                           PE,
-                           0.0);
+    ConstructHit(hitThreshold, context, pulse, hitVector, calibrator, use_start_time);
   }
 
 } // End namespace opdet
@@ -41,6 +41,17 @@ namespace opdet {
                     calib::IPhotonCalibrator const&,
                     bool use_start_time = false);
 
+  /// Same as above, for waveforms owned elsewhere (e.g. by several data products)
+  void RunHitFinder(std::vector<raw::OpDetWaveform const*> const&,
+                    std::vector<recob::OpHit>&,
+                    pmtana::PulseRecoManager const&,
+                    pmtana::PMTPulseRecoBase const&,
+                    geo::GeometryCore const&,
+                    float,
+                    detinfo::DetectorClocksData const&,
+                    calib::IPhotonCalibrator const&,
+                    bool use_start_time = false);
+
   void ConstructHit(float,
                     int,
                     double,
@@ -6,11 +6,22 @@
 
 #include "PMTPedestalBase.h"
 #include "OpticalRecoException.h"
+
+#include <algorithm>
 #include <sstream>
+
 namespace pmtana {
 
   //**************************************************************
-  PMTPedestalBase::PMTPedestalBase(std::string name) : _name(name), _mean_v(), _sigma_v()
+  PMTPedestalBase::PMTPedestalBase(std::string name)
+    : _name(name)
+    , _mean_v()
+    , _sigma_v()
+    , _flat(false)
+    , _flat_mean(0)
+    , _flat_sigma(0)
+    , _filled(true)
+    , _zeroed(true)
   //**************************************************************
   {}
 
@@ -33,11 +44,20 @@ namespace pmtana {
     _mean_v.resize(wf.size(), 0);
     _sigma_v.resize(wf.size(), 0);
 
-    for (size_t i = 0; i < wf.size(); ++i)
-      _mean_v[i] = _sigma_v[i] = 0;
+    // only a pedestal written into the arrays needs clearing:
+    // a flat one leaves them as they are until it is requested
+    if (!_zeroed) {
+      std::fill(_mean_v.begin(), _mean_v.end(), 0);
+      std::fill(_sigma_v.begin(), _sigma_v.end(), 0);
+    }
+
+    _flat = false;
+    _filled = true;
 
     const bool res = ComputePedestal(wf, _mean_v, _sigma_v);
 
+    _zeroed = _flat;
+
     if (wf.size() != _mean_v.size())
       throw OpticalRecoException("Internal error: computed pedestal mean array length changed!");
     if (wf.size() != _sigma_v.size())
@@ -55,7 +75,7 @@ namespace pmtana {
       ss << "Invalid index: no pedestal mean exist @ " << i;
       throw OpticalRecoException(ss.str());
     }
-    return _mean_v[i];
+    return _flat ? _flat_mean : _mean_v[i];
   }
 
   //*******************************************
@@ -67,13 +87,14 @@ namespace pmtana {
       ss << "Invalid index: no pedestal sigma exist @ " << i;
       throw OpticalRecoException(ss.str());
     }
-    return _sigma_v[i];
+    return _flat ? _flat_sigma : _sigma_v[i];
   }
 
   //*************************************************
   const PedestalMean_t& PMTPedestalBase::Mean() const
   //*************************************************
   {
+    FillFlat();
     return _mean_v;
   }
 
@@ -81,6 +102,35 @@ namespace pmtana {
   const PedestalSigma_t& PMTPedestalBase::Sigma() const
   //***************************************************
   {
+    FillFlat();
     return _sigma_v;
   }
+
+  //***********************************
+  bool PMTPedestalBase::Flat() const
+  //***********************************
+  {
+    return _flat;
+  }
+
+  //********************************************************
+  void PMTPedestalBase::SetFlat(double mean, double sigma)
+  //********************************************************
+  {
+    _flat = true;
+    _flat_mean = mean;
+    _flat_sigma = sigma;
+    _filled = false;
+  }
+
+  //**************************************
+  void PMTPedestalBase::FillFlat() const
+  //**************************************
+  {
+    if (_filled) return;
+    std::fill(_mean_v.begin(), _mean_v.end(), _flat_mean);
+    std::fill(_sigma_v.begin(), _sigma_v.end(), _flat_sigma);
+    _filled = true;
+    _zeroed = false;
+  }
 }
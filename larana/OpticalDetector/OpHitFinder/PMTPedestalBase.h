@@ -45,30 +45,62 @@ namespace pmtana {
     /// Getter of the pedestal standard deviation
     double Sigma(size_t i) const;
 
-    /// Getter of the pedestal mean value
+    /**
+       Getter of the pedestal mean value.
+       A flat pedestal is written into the array on the first call, so this is not safe to call
+       concurrently with itself or with Sigma().
+    */
     const pmtana::PedestalMean_t& Mean() const;
 
-    /// Getter of the pedestal standard deviation
+    /**
+       Getter of the pedestal standard deviation.
+       A flat pedestal is written into the array on the first call, so this is not safe to call
+       concurrently with itself or with Mean().
+    */
     const pmtana::PedestalSigma_t& Sigma() const;
 
+    /// Whether the last computed pedestal has the same mean and sigma for every sample
+    bool Flat() const;
+
   protected:
     /**
        Method to compute pedestal: mean and sigma array should be filled per ADC.
-       The length of each array is guaranteed to be same.
+       The length of each array is guaranteed to be same, and all their values are zero.
     */
     virtual bool ComputePedestal(const ::pmtana::Waveform_t& wf,
                                  pmtana::PedestalMean_t& mean_v,
                                  pmtana::PedestalSigma_t& sigma_v) = 0;
 
+    /**
+       Records a pedestal that is the same for every sample. ComputePedestal may call this
+       instead of filling the arrays, which it must then leave untouched: they are filled only
+       when they are requested, and are not cleared again for the next waveform.
+    */
+    void SetFlat(double mean, double sigma);
+
   private:
     /// Name
     std::string _name;
 
+    /// Fills the per-sample arrays from a flat pedestal if not done yet
+    void FillFlat() const;
+
     /// A variable holder for pedestal mean value
-    pmtana::PedestalMean_t _mean_v;
+    mutable pmtana::PedestalMean_t _mean_v;
 
     /// A variable holder for pedestal standard deviation
-    pmtana::PedestalSigma_t _sigma_v;
+    mutable pmtana::PedestalSigma_t _sigma_v;
+
+    /// Whether the pedestal is flat, with _flat_mean and _flat_sigma for every sample
+    bool _flat;
+    double _flat_mean;
+    double _flat_sigma;
+
+    /// Whether _mean_v and _sigma_v hold the pedestal
+    mutable bool _filled;
+
+    /// Whether _mean_v and _sigma_v are all zero
+    mutable bool _zeroed;
   };
 }
 #endif
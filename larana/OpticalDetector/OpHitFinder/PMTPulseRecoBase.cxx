@@ -42,6 +42,23 @@ namespace pmtana {
     return _status;
   }
 
+  //*****************************************************************************
+  bool PMTPulseRecoBase::Reconstruct(const Waveform_t& wf, double ped_mean, double ped_sigma)
+  //*****************************************************************************
+  {
+    _status = this->RecoFlatPulse(wf, ped_mean, ped_sigma);
+    return _status;
+  }
+
+  //*******************************************************************************
+  bool PMTPulseRecoBase::RecoFlatPulse(const Waveform_t& wf, double ped_mean, double ped_sigma)
+  //*******************************************************************************
+  {
+    _flat_mean_v.assign(wf.size(), ped_mean);
+    _flat_sigma_v.assign(wf.size(), ped_sigma);
+    return this->RecoPulse(wf, _flat_mean_v, _flat_sigma_v);
+  }
+
   //*****************************************************************************
   bool CheckIndex(const std::vector<short>& wf, const size_t& begin, size_t& end)
   //*****************************************************************************
@@ -48,6 +48,32 @@ namespace pmtana {
 
   typedef std::vector<pmtana::pulse_param> pulse_param_array;
 
+  /// Per-sample pedestal, as the mean and standard deviation arrays
+  struct PedestalArrays {
+    const PedestalMean_t& mean_v;
+    const PedestalSigma_t& sigma_v;
+
+    double Mean(size_t i) const { return mean_v[i]; }
+    double Sigma(size_t i) const { return sigma_v[i]; }
+    PedestalMean_t MeanRange(size_t begin, size_t end) const
+    {
+      return {mean_v.begin() + begin, mean_v.begin() + end};
+    }
+  };
+
+  /// Pedestal with the same mean and standard deviation for every sample
+  struct FlatPedestal {
+    double mean;
+    double sigma;
+
+    double Mean(size_t) const { return mean; }
+    double Sigma(size_t) const { return sigma; }
+    PedestalMean_t MeanRange(size_t begin, size_t end) const
+    {
+      return PedestalMean_t(end - begin, mean);
+    }
+  };
+
   /**
    \class PMTPulseRecoBase
    The base class of pulse reconstruction algorithms. All algorithms should inherit from this calss
@@ -88,6 +114,9 @@ namespace pmtana {
                      const pmtana::PedestalMean_t&,
                      const pmtana::PedestalSigma_t&);
 
+    /// Same as above, for a pedestal with the same mean and standard deviation for every sample
+    bool Reconstruct(const pmtana::Waveform_t&, double ped_mean, double ped_sigma);
+
     /** A getter for the pulse_param struct object.
       Reconstruction algorithm may have more than one pulse reconstructed from an input waveform.
       Note you must, accordingly, provide an index key to specify which pulse_param object to be retrieved.
@@ -107,11 +136,21 @@ namespace pmtana {
     /// Status after pulse reconstruction
     bool _status;
 
+    /// Flat pedestal expanded for RecoPulse by the default RecoFlatPulse
+    PedestalMean_t _flat_mean_v;
+    PedestalSigma_t _flat_sigma_v;
+
   protected:
     virtual bool RecoPulse(const pmtana::Waveform_t&,
                            const pmtana::PedestalMean_t&,
                            const pmtana::PedestalSigma_t&) = 0;
 
+    /**
+      Reconstruction with a flat pedestal. By default the pedestal is expanded to per-sample
+      arrays for RecoPulse; algorithms reading the pedestal per sample should specialize it.
+    */
+    virtual bool RecoFlatPulse(const pmtana::Waveform_t&, double ped_mean, double ped_sigma);
+
     /// A container array of pulse_param struct objects to store (possibly multiple) reconstructed pulse(s).
     pulse_param_array _pulse_v;
 
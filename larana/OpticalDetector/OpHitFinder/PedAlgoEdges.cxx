@@ -41,8 +41,8 @@ namespace pmtana {
 
   //*********************************************************************
   bool PedAlgoEdges::ComputePedestal(const pmtana::Waveform_t& wf,
-                                     pmtana::PedestalMean_t& mean_v,
-                                     pmtana::PedestalSigma_t& sigma_v)
+                                     pmtana::PedestalMean_t& /*mean_v*/,
+                                     pmtana::PedestalSigma_t& /*sigma_v*/)
   //*********************************************************************
   {
 
@@ -52,18 +52,10 @@ namespace pmtana {
     case kHEAD:
       ped_mean = mean(wf, 0, _nsample_front);
       ped_sigma = std(wf, ped_mean, 0, _nsample_front);
-      for (auto& v : mean_v)
-        v = ped_mean;
-      for (auto& v : sigma_v)
-        v = ped_sigma;
       break;
     case kTAIL:
       ped_mean = mean(wf, (wf.size() - _nsample_tail), _nsample_tail);
       ped_sigma = std(wf, ped_mean, (wf.size() - _nsample_tail), _nsample_tail);
-      for (auto& v : mean_v)
-        v = ped_mean;
-      for (auto& v : sigma_v)
-        v = ped_sigma;
       break;
     case kBOTH:
       double ped_mean_head = mean(wf, 0, _nsample_front);
@@ -77,12 +69,9 @@ namespace pmtana {
         ped_mean = ped_mean_tail;
         ped_sigma = ped_sigma_tail;
       }
-      for (auto& v : mean_v)
-        v = ped_mean;
-      for (auto& v : sigma_v)
-        v = ped_sigma;
       break;
     }
+    SetFlat(ped_mean, ped_sigma);
     return true;
   }
 
@@ -123,8 +123,8 @@ namespace pmtana {
     unsigned nbins = 1000;
 
     //////////////////seg faulting...
-    const auto mode_mean = BinnedMaxOccurrence(mean_v, nbins);
-    const auto mode_sigma = BinnedMaxOccurrence(sigma_v, nbins);
+    const auto mode_mean = BinnedMaxOccurrence(mean_v, nbins, _bin_ctr_v);
+    const auto mode_sigma = BinnedMaxOccurrence(sigma_v, nbins, _bin_ctr_v);
 
     //auto mode_mean  = BinnedMaxTH1D(mean_v ,nbins);
     //auto mode_sigma = BinnedMaxTH1D(sigma_v,nbins);
@@ -23,6 +23,7 @@ namespace fhicl {
 #include "larana/OpticalDetector/OpHitFinder/OpticalRecoTypes.h"
 
 #include <string>
+#include <vector>
 
 namespace pmtana {
 
@@ -60,6 +61,9 @@ namespace pmtana {
 
     int _n_presamples;
 
+    /// Bin counts scratch for the mode finding, reused across waveforms
+    std::vector<size_t> _bin_ctr_v;
+
     //double _random_shift;
   };
 }
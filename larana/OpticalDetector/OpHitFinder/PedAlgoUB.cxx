@@ -39,10 +39,7 @@ namespace pmtana {
       double ped_mean = wf.front(); //first sample
       double ped_sigma = 0;
 
-      for (auto& v : mean_v)
-        v = ped_mean;
-      for (auto& v : sigma_v)
-        v = ped_sigma;
+      SetFlat(ped_mean, ped_sigma);
 
       return true;
     }
@@ -50,8 +47,12 @@ namespace pmtana {
     else {
 
       _beamgatealgo.Evaluate(wf);
-      mean_v = _beamgatealgo.Mean();
-      sigma_v = _beamgatealgo.Sigma();
+      if (_beamgatealgo.Flat())
+        SetFlat(_beamgatealgo.Mean(0), _beamgatealgo.Sigma(0));
+      else {
+        mean_v = _beamgatealgo.Mean();
+        sigma_v = _beamgatealgo.Sigma();
+      }
 
       return true;
     }
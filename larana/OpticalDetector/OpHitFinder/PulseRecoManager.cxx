@@ -13,6 +13,19 @@
 
 namespace pmtana {
 
+  namespace {
+
+    // Runs the pulse algorithm, handing over a flat pedestal as its mean and sigma
+    bool RunPulseReco(PMTPulseRecoBase& pulse_algo,
+                      const Waveform_t& wf,
+                      const PMTPedestalBase& ped_algo)
+    {
+      if (ped_algo.Flat()) return pulse_algo.Reconstruct(wf, ped_algo.Mean(0), ped_algo.Sigma(0));
+      return pulse_algo.Reconstruct(wf, ped_algo.Mean(), ped_algo.Sigma());
+    }
+
+  }
+
   //*******************************************************
   PulseRecoManager::PulseRecoManager() : _ped_algo(nullptr)
   //*******************************************************
@@ -61,7 +74,7 @@ namespace pmtana {
         ped_status = ped_status && ped_algo->Evaluate(wf);
 
         pulse_reco_status = (ped_status && pulse_reco_status &&
-                             pulse_algo->Reconstruct(wf, ped_algo->Mean(), ped_algo->Sigma()));
+                             RunPulseReco(*pulse_algo, wf, *ped_algo));
       }
       else {
 
@@ -71,8 +84,7 @@ namespace pmtana {
           throw OpticalRecoException(ss.str());
         }
 
-        pulse_reco_status =
-          (pulse_reco_status && pulse_algo->Reconstruct(wf, _ped_algo->Mean(), _ped_algo->Sigma()));
+        pulse_reco_status = (pulse_reco_status && RunPulseReco(*pulse_algo, wf, *_ped_algo));
       }
     }
 
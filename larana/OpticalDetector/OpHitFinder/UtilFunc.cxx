@@ -6,8 +6,6 @@
 #include <cmath>
 #include <numeric>
 
-#include "TH1D.h"
-
 namespace pmtana {
 
   double mean(const std::vector<short>& wf, size_t start, size_t nsample)
@@ -57,7 +55,9 @@ namespace pmtana {
     return sigma;
   }
 
-  double BinnedMaxOccurrence(const PedestalMean_t& mean_v, const size_t nbins)
+  double BinnedMaxOccurrence(const PedestalMean_t& mean_v,
+                             const size_t nbins,
+                             std::vector<size_t>& ctr_v)
   {
     if (nbins < 1) throw OpticalRecoException("Cannot have 0 binning");
 
@@ -70,15 +70,16 @@ namespace pmtana {
     //std::cout<<"Min: "<<(*res.first)<<" Max: "<<(*res.second)<<" Width: "<<bin_width<<std::endl;
 
     // Construct array of nbins
-    static std::vector<size_t> ctr_v(nbins, 0);
-    for (auto& v : ctr_v)
-      v = 0;
+    ctr_v.assign(nbins, 0);
     for (auto const& v : mean_v) {
 
       size_t index = int((v - (*res.first)) / bin_width);
       //std::cout<<"adc = "<<v<<" width = "<<bin_width<< " ... "
       //<<index<<" / "<<ctr_v.size()<<std::endl;
 
+      // the maximum lands on the upper edge of the last bin
+      if (index >= nbins) index = nbins - 1;
+
       ctr_v[index]++;
     }
 
@@ -100,6 +101,12 @@ namespace pmtana {
     return (mean_max_occurrence / num_occurrence);
   }
 
+  double BinnedMaxOccurrence(const PedestalMean_t& mean_v, const size_t nbins)
+  {
+    std::vector<size_t> ctr_v;
+    return BinnedMaxOccurrence(mean_v, nbins, ctr_v);
+  }
+
   // template<typename W>
   int sign(double val)
   {
@@ -109,18 +116,36 @@ namespace pmtana {
     return 0;
   }
 
-  double BinnedMaxTH1D(const std::vector<double>& v, int bins)
+  double BinnedMaxTH1D(const std::vector<double>& v, int bins, std::vector<size_t>& ctr_v)
   {
+    if (bins < 1) throw OpticalRecoException("Cannot have 0 binning");
+    if (v.empty()) throw OpticalRecoException("Cannot bin an empty vector");
+
+    auto res = std::minmax_element(std::begin(v), std::end(v));
+    const double xmin = *res.first;
+    const double xmax = *res.second;
 
-    auto max_it = std::max_element(std::begin(v), std::end(v));
-    auto min_it = std::min_element(std::begin(v), std::end(v));
+    if (!(xmin < xmax)) return xmin;
 
-    TH1D th("th", ";;", bins, *min_it, *max_it);
+    // same bin assignment as TAxis::FindBin; values at xmax go to the overflow
+    ctr_v.assign(bins, 0);
+    for (auto const& x : v) {
+      if (!(x < xmax)) continue;
+      const int index = int(bins * (x - xmin) / (xmax - xmin));
+      if (index < bins) ctr_v[index]++;
+    }
 
-    for (const auto& m : v)
-      th.Fill(m);
+    // first bin with the highest count, as TH1::GetMaximumBin
+    const size_t max_bin = std::max_element(std::begin(ctr_v), std::end(ctr_v)) - std::begin(ctr_v);
 
-    return th.GetXaxis()->GetBinCenter(th.GetMaximumBin());
+    const double bin_width = (xmax - xmin) / bins;
+    return xmin + max_bin * bin_width + 0.5 * bin_width;
+  }
+
+  double BinnedMaxTH1D(const std::vector<double>& v, int bins)
+  {
+    std::vector<size_t> ctr_v;
+    return BinnedMaxTH1D(v, bins, ctr_v);
   }
 
 }
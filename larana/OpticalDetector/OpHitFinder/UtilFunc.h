@@ -17,8 +17,16 @@ namespace pmtana {
              size_t start = 0,
              size_t nsample = 0);
 
+  /// Mean center of the most populated bins; ctr_v is scratch space for the bin counts
+  double BinnedMaxOccurrence(const PedestalMean_t& mean_v,
+                             const size_t nbins,
+                             std::vector<size_t>& ctr_v);
+
   double BinnedMaxOccurrence(const PedestalMean_t& mean_v, const size_t nbins);
 
+  /// Center of the first most populated bin, binned as TH1D does; ctr_v is scratch space
+  double BinnedMaxTH1D(const std::vector<double>& v, int bins, std::vector<size_t>& ctr_v);
+
   double BinnedMaxTH1D(const std::vector<double>& v, int bins);
 
   int sign(double val);
@@ -231,28 +231,26 @@ namespace opdet {
     }
     else {
 
-      // Reserve a large enough array
-      int totalsize = 0;
-      for (auto label : fInputLabels) {
+      // Point to the waveforms to process; they stay in their data products, uncopied
+      std::vector<art::Handle<std::vector<raw::OpDetWaveform>>> wfHandles;
+      wfHandles.reserve(fInputLabels.size());
+
+      size_t totalsize = 0;
+      for (auto const& label : fInputLabels) {
         art::Handle<std::vector<raw::OpDetWaveform>> wfHandle;
         evt.getByLabel(fInputModule, label, wfHandle);
         if (!wfHandle.isValid()) continue; // Skip non-existent collections
         totalsize += wfHandle->size();
+        wfHandles.push_back(wfHandle);
       }
 
-      std::vector<raw::OpDetWaveform> WaveformVector;
+      std::vector<raw::OpDetWaveform const*> WaveformVector;
       WaveformVector.reserve(totalsize);
 
-      for (auto label : fInputLabels) {
-        art::Handle<std::vector<raw::OpDetWaveform>> wfHandle;
-        evt.getByLabel(fInputModule, label, wfHandle);
-        if (!wfHandle.isValid()) continue; // Skip non-existent collections
-
-        //WaveformVector.insert(WaveformVector.end(),
-        //                      wfHandle->begin(), wfHandle->end());
+      for (auto const& wfHandle : wfHandles) {
         for (auto const& wf : *wfHandle) {
           if (fChannelMasks.find(wf.ChannelNumber()) != fChannelMasks.end()) continue;
-          WaveformVector.push_back(wf);
+          WaveformVector.push_back(&wf);
         }
       }
 
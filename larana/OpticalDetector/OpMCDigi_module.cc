@@ -21,6 +21,7 @@
 #include "fhiclcpp/ParameterSet.h"
 
 // LArSoft includes
+#include "larana/OpticalDetector/ChannelRandomStream.h"
 #include "larana/OpticalDetector/OpDetResponseInterface.h"
 #include "larana/OpticalDetector/OpDigiProperties.h"
 #include "lardataobj/RawData/OpDetPulse.h"
@@ -36,6 +37,8 @@
 #include "nurandom/RandomUtils/NuRandomService.h"
 
 // C++ language includes
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 
 namespace opdet {
@@ -60,10 +63,20 @@ namespace opdet {
     std::vector<double> fSinglePEWaveform;
 
     CLHEP::HepRandomEngine& fEngine;
-    CLHEP::RandFlat fFlatRandom;
-    CLHEP::RandPoisson fPoissonRandom;
+    ChannelRandomStream fChannelStream; // dark noise and rounding of each channel
 
-    void AddTimedWaveform(int time, std::vector<double>& OldPulse, std::vector<double>& NewPulse);
+    // Photon counts per time bin, only for the channels with photons in the event.
+    // The buffers are reused from event to event.
+    std::vector<std::vector<unsigned int>> fBinCountArena;
+    std::vector<int> fBinCountSlot; // arena slot of each channel, -1 if none yet
+    size_t fBinCountUsed = 0;
+
+    std::vector<double> fPulse;         // waveform being digitized
+    std::vector<size_t> fDarkPulseBins; // time bins of the dark pulses of the channel
+
+    std::vector<unsigned int>& PhotonsPerBin(int channel, int nSamples);
+    void SynthesizeWaveform(std::vector<unsigned int> const& PhotonsPerBin,
+                            std::vector<double>& Pulse) const;
   };
 }
 
@@ -80,8 +93,6 @@ namespace opdet {
     // create a default random engine; obtain the random seed from NuRandomService,
     // unless overridden in configuration with key "Seed"
     , fEngine(art::ServiceHandle<rndm::NuRandomService> {}->createEngine(*this, pset, "Seed"))
-    , fFlatRandom{fEngine}
-    , fPoissonRandom{fEngine}
   {
     produces<std::vector<raw::OpDetPulse>>();
 
@@ -94,18 +105,34 @@ namespace opdet {
 
   //-------------------------------------------------
 
-  void OpMCDigi::AddTimedWaveform(int binTime,
-                                  std::vector<double>& OldPulse,
-                                  std::vector<double>& NewPulse)
+  // Photon counts of the channel, cleared on first use in the event
+  std::vector<unsigned int>& OpMCDigi::PhotonsPerBin(int channel, int nSamples)
   {
-
-    if ((binTime + NewPulse.size()) > OldPulse.size()) {
-      OldPulse.resize(binTime + NewPulse.size());
+    int& slot = fBinCountSlot[channel];
+    if (slot < 0) {
+      slot = fBinCountUsed++;
+      if (fBinCountArena.size() < fBinCountUsed) fBinCountArena.emplace_back();
+      fBinCountArena[slot].assign(nSamples, 0);
     }
+    return fBinCountArena[slot];
+  }
 
-    // Add shifted NewWaveform to Waveform at pointer
-    for (size_t i = 0; i != NewPulse.size(); ++i) {
-      OldPulse.at(binTime + i) += NewPulse.at(i);
+  //-------------------------------------------------
+
+  // Superimposes the single PE waveform once for every photon in each time bin;
+  // the response of the photons in a bin is added in one go
+  void OpMCDigi::SynthesizeWaveform(std::vector<unsigned int> const& PhotonsPerBin,
+                                    std::vector<double>& Pulse) const
+  {
+    size_t const nSamples = Pulse.size();
+
+    for (size_t binTime = 0; binTime != PhotonsPerBin.size(); ++binTime) {
+      unsigned int const nPhotons = PhotonsPerBin[binTime];
+      if (nPhotons == 0) continue;
+
+      size_t const nShape = std::min(fSinglePEWaveform.size(), nSamples - binTime);
+      for (size_t i = 0; i != nShape; ++i)
+        Pulse[binTime + i] += nPhotons * fSinglePEWaveform[i];
     }
   }
 
@@ -115,6 +142,9 @@ namespace opdet {
   {
     auto StoragePtr = std::make_unique<std::vector<raw::OpDetPulse>>();
 
+    // Each channel draws from its own stream of this event
+    std::uint64_t const eventKey = ChannelRandomStream::EventKey(fEngine);
+
     bool const fUseLitePhotons = art::ServiceHandle<sim::LArG4Parameters const> {}
     ->UseLitePhotons();
 
@@ -128,9 +158,10 @@ namespace opdet {
     int const nSamples = (TimeEnd_ns - TimeBegin_ns) * SampleFreq_ns;
     int const NOpChannels = odresponse->NOpChannels();
 
-    // This vector will store all the waveforms we will make
-    std::vector<std::vector<double>> PulsesFromDetPhotons(NOpChannels,
-                                                          std::vector<double>(nSamples, 0.0));
+    // Number of detected photons arriving in each time bin of each channel;
+    // the waveforms are synthesized from these counts
+    fBinCountSlot.assign(NOpChannels, -1);
+    fBinCountUsed = 0;
 
     if (!fUseLitePhotons) {
       // Read in the Sim Photons
@@ -154,7 +185,7 @@ namespace opdet {
           // that we have to accommodate for the beginning time
           if ((Phot.Time > TimeBegin_ns) && (Phot.Time < TimeEnd_ns)) {
             auto const binTime = static_cast<int>((Phot.Time - TimeBegin_ns) * SampleFreq_ns);
-            AddTimedWaveform(binTime, PulsesFromDetPhotons[readoutCh], fSinglePEWaveform);
+            if (binTime < nSamples) ++PhotonsPerBin(readoutCh, nSamples)[binTime];
           }
         } // for each Photon in SimPhotons
       }
@@ -178,7 +209,7 @@ namespace opdet {
               // Notice that we have to accommodate for the beginning time
               if ((pr.first > TimeBegin_ns) && (pr.first < TimeEnd_ns)) {
                 auto const binTime = static_cast<int>((pr.first - TimeBegin_ns) * SampleFreq_ns);
-                AddTimedWaveform(binTime, PulsesFromDetPhotons[readoutCh], fSinglePEWaveform);
+                if (binTime < nSamples) ++PhotonsPerBin(readoutCh, nSamples)[binTime];
               }
             } // random QE cut
           }
@@ -189,42 +220,59 @@ namespace opdet {
     // Create vector of output objects, add dark noise and apply
     //  saturation
 
-    std::vector<raw::OpDetPulse*> ThePulses(NOpChannels);
     for (int iCh = 0; iCh != NOpChannels; ++iCh) {
-      PulsesFromDetPhotons[iCh].resize((TimeEnd_ns - TimeBegin_ns) * SampleFreq_ns);
+      fChannelStream.Select(eventKey, iCh);
+      CLHEP::RandFlat flatRandom{fChannelStream.Engine()};
+      CLHEP::RandPoisson poissonRandom{fChannelStream.Engine()};
 
       // Add dark noise
       double const MeanDarkPulses = fDarkRate * (fTimeEnd - fTimeBegin) / 1000000;
-      unsigned const int NumberOfPulses = fPoissonRandom.fire(MeanDarkPulses);
+      unsigned const int NumberOfPulses = poissonRandom.fire(MeanDarkPulses);
 
+      // Unlike the photons, the dark pulses are not truncated at the end of the window:
+      // the waveform is extended to hold the full response of the last ones
+      size_t pulseSize = nSamples;
+      fDarkPulseBins.clear();
       for (size_t i = 0; i != NumberOfPulses; ++i) {
-        double const PulseTime = (fTimeEnd - fTimeBegin) * fFlatRandom.fire(1.0);
-        int const binTime = static_cast<int>(PulseTime * fSampleFreq);
+        double const PulseTime = (fTimeEnd - fTimeBegin) * flatRandom.fire(1.0);
+        size_t const binTime = static_cast<size_t>(PulseTime * fSampleFreq);
+
+        fDarkPulseBins.push_back(binTime);
+        pulseSize = std::max(pulseSize, binTime + fSinglePEWaveform.size());
+      }
+
+      fPulse.assign(nSamples, 0.0);
+      if (fBinCountSlot[iCh] >= 0) SynthesizeWaveform(fBinCountArena[fBinCountSlot[iCh]], fPulse);
 
-        AddTimedWaveform(binTime, PulsesFromDetPhotons[iCh], fSinglePEWaveform);
+      // the dark pulses are drawn channel by channel and added directly, so that only the
+      // channels with detected photons take a slot of the arena
+      fPulse.resize(pulseSize, 0.0);
+      for (size_t const binTime : fDarkPulseBins) {
+        for (size_t i = 0; i != fSinglePEWaveform.size(); ++i)
+          fPulse[binTime + i] += fSinglePEWaveform[i];
       }
 
       // Apply saturation for large signals
-      for (size_t i = 0; i != PulsesFromDetPhotons[iCh].size(); ++i) {
-        if (PulsesFromDetPhotons[iCh].at(i) > fSaturationScale)
-          PulsesFromDetPhotons[iCh].at(i) = fSaturationScale;
+      for (size_t i = 0; i != fPulse.size(); ++i) {
+        if (fPulse.at(i) > fSaturationScale) fPulse.at(i) = fSaturationScale;
       }
 
       // Produce ADC pulse of integers rather than doubles
 
       std::vector<short> shortvec;
+      shortvec.reserve(fPulse.size());
 
-      for (size_t i = 0; i != PulsesFromDetPhotons[iCh].size(); ++i) {
+      for (size_t i = 0; i != fPulse.size(); ++i) {
         // Throw randoms to fairly sample +ve and -ve side of doubles
-        int ThisSample = PulsesFromDetPhotons[iCh].at(i);
+        int ThisSample = fPulse.at(i);
         if (ThisSample > 0) {
-          if (fFlatRandom.fire(1.0) > (ThisSample - int(ThisSample)))
+          if (flatRandom.fire(1.0) > (ThisSample - int(ThisSample)))
             shortvec.push_back(int(ThisSample));
           else
             shortvec.push_back(int(ThisSample) + 1);
         }
         else {
-          if (fFlatRandom.fire(1.0) > (int(ThisSample) - ThisSample))
+          if (flatRandom.fire(1.0) > (int(ThisSample) - ThisSample))
             shortvec.push_back(int(ThisSample));
           else
             shortvec.push_back(int(ThisSample) - 1);
@@ -7,6 +7,7 @@
 // and produces a digitized waveform.
 
 // LArSoft includes
+#include "larana/OpticalDetector/ChannelRandomStream.h"
 #include "larana/OpticalDetector/OpDigiProperties.h"
 #include "larcore/Geometry/Geometry.h"
 #include "lardataobj/OpticalDetectorData/ChannelData.h"
@@ -30,6 +31,7 @@
 #include "CLHEP/Random/RandPoisson.h"
 
 // C++ language includes
+#include <cstdint>
 #include <cstring>
 
 namespace opdet {
@@ -59,16 +61,16 @@ namespace opdet {
     bool fSimGainSpread;
 
     CLHEP::HepRandomEngine& fEngine;
-    CLHEP::RandFlat fFlatRandom;
-    CLHEP::RandPoisson fPoissonRandom;
-    void AddDarkNoise(std::vector<double>& RawWF, double gain);
+    ChannelRandomStream fChannelStream;
+    void AddDarkNoise(std::vector<double>& RawWF, double gain, CLHEP::HepRandomEngine& engine);
     void AddWaveform(optdata::TimeSlice_t time,
                      std::vector<double>& OldPulse,
                      std::vector<double>& NewPulse,
                      double factor,
                      bool extend = false);
     optdata::ChannelData ApplyDigitization(std::vector<double> const RawWF,
-                                           optdata::Channel_t const ch) const;
+                                           optdata::Channel_t const ch,
+                                           CLHEP::HepRandomEngine& engine) const;
     art::ServiceHandle<OpDigiProperties> fOpDigiProperties;
     art::ServiceHandle<geo::Geometry const> fGeom;
   };
@@ -80,13 +82,19 @@ namespace opdet {
 
 } //end namespace opdet
 
+namespace {
+
+  // Purposes of the per-channel random streams
+  constexpr std::uint32_t kPhotonStream = 0;       // QE sampling and gain spread of the photons
+  constexpr std::uint32_t kDigitizationStream = 1; // dark noise, gain spread and digitization
+
+}
+
 namespace opdet {
 
   OptDetDigitizer::OptDetDigitizer(fhicl::ParameterSet const& pset)
     : EDProducer{pset}
     , fEngine(art::ServiceHandle<rndm::NuRandomService>()->createEngine(*this, pset, "Seed"))
-    , fFlatRandom{fEngine}
-    , fPoissonRandom{fEngine}
   {
     // Infrastructure piece
     produces<std::vector<optdata::ChannelDataGroup>>();
@@ -124,22 +132,26 @@ namespace opdet {
 
   //-------------------------------------------------
 
-  void OptDetDigitizer::AddDarkNoise(std::vector<double>& RawWF, double gain)
+  void OptDetDigitizer::AddDarkNoise(std::vector<double>& RawWF,
+                                     double gain,
+                                     CLHEP::HepRandomEngine& engine)
   {
     // Add dark noise
     double MeanDarkPulses = fDarkRate * (fTimeEnd - fTimeBegin) / 1000000;
 
-    unsigned int NumberOfPulses = fPoissonRandom.fire(MeanDarkPulses);
+    unsigned int NumberOfPulses = CLHEP::RandPoisson::shoot(&engine, MeanDarkPulses);
     for (size_t i = 0; i != NumberOfPulses; ++i) {
-      double PulseTime_ns = fTimeBegin * 1000 + (fTimeEnd - fTimeBegin) * 1000 *
-                                                  (fFlatRandom.fire(1.0)); // Should be in ns
+      double PulseTime_ns =
+        fTimeBegin * 1000 +
+        (fTimeEnd - fTimeBegin) * 1000 * (CLHEP::RandFlat::shoot(&engine, 1.0)); // Should be in ns
       optdata::TimeSlice_t PulseTime_ts = fOpDigiProperties->GetTimeSlice(PulseTime_ns);
       AddWaveform(PulseTime_ts, RawWF, fSinglePEWaveform, gain);
     }
   }
 
   optdata::ChannelData OptDetDigitizer::ApplyDigitization(std::vector<double> const rawWF,
-                                                          optdata::Channel_t const ch) const
+                                                          optdata::Channel_t const ch,
+                                                          CLHEP::HepRandomEngine& engine) const
   {
     //
     // Digitization includes...
@@ -158,7 +170,7 @@ namespace opdet {
       optdata::ADC_Count_t thisCount = (optdata::ADC_Count_t)(thisSample) + baseMean;
 
       // (a) amplitude digitization
-      if (CLHEP::RandFlat::shoot(1.0) < (thisSample - int(thisSample))) thisCount += 1;
+      if (CLHEP::RandFlat::shoot(&engine, 1.0) < (thisSample - int(thisSample))) thisCount += 1;
 
       // (b) saturation
       if (thisCount > fSaturationScale) thisCount = fSaturationScale;
@@ -168,11 +180,11 @@ namespace opdet {
 
     // (c) pedestal fluctuation
     double timeSpan = chData.size() * 1.e-6 / (fOpDigiProperties->SampleFreq());
-    unsigned int nFluc = CLHEP::RandPoisson::shoot(fPedFlucRate * timeSpan);
+    unsigned int nFluc = CLHEP::RandPoisson::shoot(&engine, fPedFlucRate * timeSpan);
     for (size_t i = 0; i < nFluc; ++i) {
-      optdata::TimeSlice_t pulseTime(CLHEP::RandFlat::shoot(0.0, (double)(chData.size())));
+      optdata::TimeSlice_t pulseTime(CLHEP::RandFlat::shoot(&engine, 0.0, (double)(chData.size())));
       optdata::ADC_Count_t amp = chData[pulseTime];
-      if (CLHEP::RandFlat::shoot(0., 1.) > 0.5) {
+      if (CLHEP::RandFlat::shoot(&engine, 0., 1.) > 0.5) {
         amp += fPedFlucAmp;
         if (amp > fSaturationScale) amp = fSaturationScale;
       }
@@ -197,6 +209,9 @@ namespace opdet {
     std::unique_ptr<std::vector<optdata::ChannelDataGroup>> StoragePtr(
       new std::vector<optdata::ChannelDataGroup>);
 
+    // Each channel draws from its own streams of this event
+    std::uint64_t const eventKey = ChannelRandomStream::EventKey(fEngine);
+
     // Read in the Sim Photons
     sim::SimPhotonsCollection ThePhotCollection =
       sim::SimListUtils::GetSimPhotonsCollection(evt, fInputModule);
@@ -246,17 +261,25 @@ namespace opdet {
       const sim::SimPhotons& ThePhot = itOpDet->second;
 
       int ch = ThePhot.OpChannel();
+
+      fChannelStream.Select(eventKey, itOpDet->first, kPhotonStream);
+      CLHEP::HepRandomEngine& engine = fChannelStream.Engine();
+
       // For every photon in the hit:
       for (const sim::OnePhoton& Phot : ThePhot) {
         // Sample a random subset according to QE
-        if (fFlatRandom.fire(1.0) <= fQE) {
+        if (CLHEP::RandFlat::shoot(&engine, 1.0) <= fQE) {
           optdata::TimeSlice_t PhotonTime(fOpDigiProperties->GetTimeSlice(Phot.Time));
           if (Phot.Time > timeBegin_ns && Phot.Time < timeEnd_ns) {
             if (fSimGainSpread) {
-              AddWaveform(
-                PhotonTime, rawWF_HighGain[ch], fSinglePEWaveform, fOpDigiProperties->HighGain(ch));
-              AddWaveform(
-                PhotonTime, rawWF_LowGain[ch], fSinglePEWaveform, fOpDigiProperties->LowGain(ch));
+              AddWaveform(PhotonTime,
+                          rawWF_HighGain[ch],
+                          fSinglePEWaveform,
+                          fOpDigiProperties->HighGain(ch, engine));
+              AddWaveform(PhotonTime,
+                          rawWF_LowGain[ch],
+                          fSinglePEWaveform,
+                          fOpDigiProperties->LowGain(ch, engine));
             }
             else {
               AddWaveform(PhotonTime,
@@ -280,19 +303,22 @@ namespace opdet {
       rawWF_LowGain[iCh].resize((timeEnd_ns - timeBegin_ns) * sampleFreq_ns);
       rawWF_HighGain[iCh].resize((timeEnd_ns - timeBegin_ns) * sampleFreq_ns);
 
+      fChannelStream.Select(eventKey, iCh, kDigitizationStream);
+      CLHEP::HepRandomEngine& engine = fChannelStream.Engine();
+
       // Add dark noise
       if (fSimGainSpread) {
-        AddDarkNoise(rawWF_LowGain[iCh], fOpDigiProperties->LowGain(iCh));
-        AddDarkNoise(rawWF_HighGain[iCh], fOpDigiProperties->HighGain(iCh));
+        AddDarkNoise(rawWF_LowGain[iCh], fOpDigiProperties->LowGain(iCh, engine), engine);
+        AddDarkNoise(rawWF_HighGain[iCh], fOpDigiProperties->HighGain(iCh, engine), engine);
       }
       else {
-        AddDarkNoise(rawWF_LowGain[iCh], fOpDigiProperties->LowGainMean(iCh));
-        AddDarkNoise(rawWF_HighGain[iCh], fOpDigiProperties->HighGainMean(iCh));
+        AddDarkNoise(rawWF_LowGain[iCh], fOpDigiProperties->LowGainMean(iCh), engine);
+        AddDarkNoise(rawWF_HighGain[iCh], fOpDigiProperties->HighGainMean(iCh), engine);
       }
 
       // Apply digitization and make channel data
-      optdata::ChannelData chData_HighGain(ApplyDigitization(rawWF_HighGain[iCh], iCh));
-      optdata::ChannelData chData_LowGain(ApplyDigitization(rawWF_LowGain[iCh], iCh));
+      optdata::ChannelData chData_HighGain(ApplyDigitization(rawWF_HighGain[iCh], iCh, engine));
+      optdata::ChannelData chData_LowGain(ApplyDigitization(rawWF_LowGain[iCh], iCh, engine));
 
       rawWFGroup_HighGain.push_back(chData_HighGain);
       rawWFGroup_LowGain.push_back(chData_LowGain);
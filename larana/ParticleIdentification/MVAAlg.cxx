@@ -24,9 +24,12 @@
 
 #include "Fit/Fitter.h"
 #include "Math/Functor.h"
+#include "TMVA/MethodBase.h"
 #include "TPrincipal.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -70,7 +73,13 @@ mvapid::MVAAlg::MVAAlg(fhicl::ParameterSet const& pset)
   }
 
   for (unsigned int iMethod = 0; iMethod != fMVAMethods.size(); ++iMethod) {
-    fReader.BookMVA(fMVAMethods[iMethod], fWeightFiles[iMethod]);
+    TMVA::MethodBase* method =
+      dynamic_cast<TMVA::MethodBase*>(fReader.BookMVA(fMVAMethods[iMethod], fWeightFiles[iMethod]));
+    if (!method) {
+      throw cet::exception("MVAPID") << "Unable to book MVA method " << fMVAMethods[iMethod]
+                                     << " from weight file " << fWeightFiles[iMethod] << std::endl;
+    }
+    fMVAMethodPtrs.push_back(method);
   }
 }
 
@@ -150,12 +159,16 @@ void mvapid::MVAAlg::RunPID(art::Event& evt,
     art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(evt, clockData);
   this->PrepareEvent(evt, clockData);
 
+  //Features are computed for all objects first; the MVA outputs are filled in one batch below
+  const std::size_t firstResult = result.size();
+  fResHolder.mvaOutput.clear();
+
   for (auto trackIter = fTracks.begin(); trackIter != fTracks.end(); ++trackIter) {
     mvapid::MVAAlg::SortedObj sortedObj;
 
     std::vector<double> eVals, eVecs;
     int isStoppingReco;
-    this->RunPCA(fTracksToHits[*trackIter], eVals, eVecs);
+    this->RunPCA(fTracksToHits[trackIter->key()], eVals, eVecs);
     double evalRatio;
     if (eVals[0] < 0.0001)
       evalRatio = 0.0;
@@ -170,7 +183,7 @@ void mvapid::MVAAlg::RunPID(art::Event& evt,
 
     fResHolder.isTrack = 1;
     fResHolder.isStoppingReco = isStoppingReco;
-    fResHolder.nSpacePoints = sortedObj.hitMap.size();
+    fResHolder.nSpacePoints = sortedObj.sortedHits.size();
     fResHolder.trackID = (*trackIter)->ID();
     fResHolder.evalRatio = evalRatio;
     fResHolder.concentration = concentration;
@@ -184,9 +197,6 @@ void mvapid::MVAAlg::RunPID(art::Event& evt,
       fResHolder.dEdxEndRatio = dEdxEnd / dEdxPenultimate;
     fResHolder.length = sortedObj.length;
 
-    for (auto methodIter = fMVAMethods.begin(); methodIter != fMVAMethods.end(); ++methodIter) {
-      fResHolder.mvaOutput[*methodIter] = fReader.EvaluateMVA(*methodIter);
-    }
     result.push_back(fResHolder);
     util::CreateAssn(evt, result, *trackIter, trackAssns);
   }
@@ -197,7 +207,7 @@ void mvapid::MVAAlg::RunPID(art::Event& evt,
     std::vector<double> eVals, eVecs;
     int isStoppingReco;
 
-    this->RunPCA(fShowersToHits[*showerIter], eVals, eVecs);
+    this->RunPCA(fShowersToHits[showerIter->key()], eVals, eVecs);
 
     double evalRatio;
     if (eVals[0] < 0.0001)
@@ -215,7 +225,7 @@ void mvapid::MVAAlg::RunPID(art::Event& evt,
 
     fResHolder.isTrack = 0;
     fResHolder.isStoppingReco = isStoppingReco;
-    fResHolder.nSpacePoints = sortedObj.hitMap.size();
+    fResHolder.nSpacePoints = sortedObj.sortedHits.size();
     fResHolder.trackID =
       (*showerIter)->ID() + 1000; //For the moment label showers by adding 1000 to ID
 
@@ -231,12 +241,47 @@ void mvapid::MVAAlg::RunPID(art::Event& evt,
       fResHolder.dEdxEndRatio = dEdxEnd / dEdxPenultimate;
     fResHolder.length = sortedObj.length;
 
-    for (auto methodIter = fMVAMethods.begin(); methodIter != fMVAMethods.end(); ++methodIter) {
-      fResHolder.mvaOutput[*methodIter] = fReader.EvaluateMVA(*methodIter);
-    }
     result.push_back(fResHolder);
     util::CreateAssn(evt, result, *showerIter, showerAssns);
   }
+
+  this->EvaluateMVAs(result, firstResult);
+}
+
+namespace {
+
+  bool HasNaNInput(const anab::MVAPIDResult& res)
+  {
+    return std::isnan(res.evalRatio) || std::isnan(res.coreHaloRatio) ||
+           std::isnan(res.concentration) || std::isnan(res.conicalness) ||
+           std::isnan(res.dEdxStart) || std::isnan(res.dEdxEnd) || std::isnan(res.dEdxEndRatio);
+  }
+
+}
+
+void mvapid::MVAAlg::EvaluateMVAs(std::vector<anab::MVAPIDResult>& results, std::size_t first)
+{
+  //Evaluate each method once over all tracks and showers of the event, rather than
+  //looking up every method again for each object
+  for (unsigned int iMethod = 0; iMethod != fMVAMethods.size(); ++iMethod) {
+    TMVA::MethodBase* method = fMVAMethodPtrs[iMethod];
+    const std::string& methodName = fMVAMethods[iMethod];
+    for (auto resIter = results.begin() + first; resIter != results.end(); ++resIter) {
+      fResHolder.evalRatio = resIter->evalRatio;
+      fResHolder.coreHaloRatio = resIter->coreHaloRatio;
+      fResHolder.concentration = resIter->concentration;
+      fResHolder.conicalness = resIter->conicalness;
+      fResHolder.dEdxStart = resIter->dEdxStart;
+      fResHolder.dEdxEnd = resIter->dEdxEnd;
+      fResHolder.dEdxEndRatio = resIter->dEdxEndRatio;
+      //Evaluating by method pointer skips the check TMVA does for method names,
+      //which returns -999 if any input is NaN (e.g. concentration with no charge)
+      if (HasNaNInput(fResHolder))
+        resIter->mvaOutput[methodName] = -999.;
+      else
+        resIter->mvaOutput[methodName] = fReader.EvaluateMVA(method);
+    }
+  }
 }
 
 void mvapid::MVAAlg::PrepareEvent(const art::Event& evt,
@@ -253,11 +298,13 @@ void mvapid::MVAAlg::PrepareEvent(const art::Event& evt,
   fTracksToSpacePoints.clear();
   fShowersToHits.clear();
   fShowersToSpacePoints.clear();
+  fOtherHitsToSpacePoints.clear();
 
   fEventT0 = trigger_offset(clockData);
 
   art::Handle<std::vector<recob::Hit>> hitsHandle;
   evt.getByLabel(fHitLabel, hitsHandle);
+  fSpacePointHitsID = hitsHandle.id();
 
   for (unsigned int iHit = 0; iHit < hitsHandle->size(); ++iHit) {
     const art::Ptr<recob::Hit> hit(hitsHandle, iHit);
@@ -292,38 +339,48 @@ void mvapid::MVAAlg::PrepareEvent(const art::Event& evt,
   art::FindManyP<recob::Hit> findShowersToHits(fShowers, evt, fShowerLabel);
   art::FindOneP<recob::Hit> findSPToHits(fSpacePoints, evt, fSpacePointLabel);
 
+  //Tracks, showers and space points are read straight from their handles, so their keys
+  //are their positions in fTracks, fShowers and fSpacePoints
+  fSpacePointsToHits.resize(fSpacePoints.size());
+  fHitsToSpacePoints.resize(hitsHandle->size());
   for (unsigned int iSP = 0; iSP < fSpacePoints.size(); ++iSP) {
-    const art::Ptr<recob::SpacePoint> spacePoint = fSpacePoints.at(iSP);
+    const art::Ptr<recob::Hit>& hit = findSPToHits.at(iSP);
+    fSpacePointsToHits[iSP] = hit;
+    if (hit.isNull()) continue;
+
+    //Hits from products other than fHitLabel are looked up by pointer
+    if (hit.id() != fSpacePointHitsID) {
+      fOtherHitsToSpacePoints[hit] = fSpacePoints[iSP];
+      continue;
+    }
 
-    const art::Ptr<recob::Hit> hit = findSPToHits.at(iSP);
-    fSpacePointsToHits[spacePoint] = hit;
-    fHitsToSpacePoints[hit] = spacePoint;
+    if (hit.key() >= fHitsToSpacePoints.size()) fHitsToSpacePoints.resize(hit.key() + 1);
+    fHitsToSpacePoints[hit.key()] = fSpacePoints[iSP];
   }
 
+  fTracksToHits.resize(fTracks.size());
+  fTracksToSpacePoints.resize(fTracks.size());
   for (unsigned int iTrack = 0; iTrack < fTracks.size(); ++iTrack) {
-    const art::Ptr<recob::Track> track = fTracks.at(iTrack);
-
-    const std::vector<art::Ptr<recob::Hit>> trackHits = findTracksToHits.at(iTrack);
+    fTracksToHits[iTrack] = findTracksToHits.at(iTrack);
 
-    for (unsigned int iHit = 0; iHit < trackHits.size(); ++iHit) {
-      const art::Ptr<recob::Hit> hit = trackHits.at(iHit);
-      fTracksToHits[track].push_back(hit);
-      if (fHitsToSpacePoints.count(hit)) {
-        fTracksToSpacePoints[track].push_back(fHitsToSpacePoints.at(hit));
-      }
+    std::vector<art::Ptr<recob::SpacePoint>>& trackSpacePoints = fTracksToSpacePoints[iTrack];
+    trackSpacePoints.reserve(fTracksToHits[iTrack].size());
+    for (const art::Ptr<recob::Hit>& hit : fTracksToHits[iTrack]) {
+      art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(hit);
+      if (sp.isNonnull()) trackSpacePoints.push_back(sp);
     }
   }
 
+  fShowersToHits.resize(fShowers.size());
+  fShowersToSpacePoints.resize(fShowers.size());
   for (unsigned int iShower = 0; iShower < fShowers.size(); ++iShower) {
-    const art::Ptr<recob::Shower> shower = fShowers.at(iShower);
-    const std::vector<art::Ptr<recob::Hit>> showerHits = findShowersToHits.at(iShower);
-
-    for (unsigned int iHit = 0; iHit < showerHits.size(); ++iHit) {
-      const art::Ptr<recob::Hit> hit = showerHits.at(iHit);
-      fShowersToHits[shower].push_back(hit);
-      if (fHitsToSpacePoints.count(hit)) {
-        fShowersToSpacePoints[shower].push_back(fHitsToSpacePoints.at(hit));
-      }
+    fShowersToHits[iShower] = findShowersToHits.at(iShower);
+
+    std::vector<art::Ptr<recob::SpacePoint>>& showerSpacePoints = fShowersToSpacePoints[iShower];
+    showerSpacePoints.reserve(fShowersToHits[iShower].size());
+    for (const art::Ptr<recob::Hit>& hit : fShowersToHits[iShower]) {
+      art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(hit);
+      if (sp.isNonnull()) showerSpacePoints.push_back(sp);
     }
   }
 
@@ -339,12 +396,38 @@ void mvapid::MVAAlg::PrepareEvent(const art::Event& evt,
   }
 }
 
+art::Ptr<recob::SpacePoint> mvapid::MVAAlg::SpacePointOf(const art::Ptr<recob::Hit>& hit) const
+{
+  if (hit.id() != fSpacePointHitsID) {
+    auto const it = fOtherHitsToSpacePoints.find(hit);
+    if (it == fOtherHitsToSpacePoints.end()) return {};
+    return it->second;
+  }
+  if (hit.key() >= fHitsToSpacePoints.size()) return {};
+  return fHitsToSpacePoints[hit.key()];
+}
+
+void mvapid::MVAAlg::SortHitsByDistance(
+  std::vector<std::pair<double, art::Ptr<recob::Hit>>>& hits)
+{
+  auto byDistance = [](const std::pair<double, art::Ptr<recob::Hit>>& a,
+                       const std::pair<double, art::Ptr<recob::Hit>>& b) {
+    return a.first < b.first;
+  };
+  auto sameDistance = [](const std::pair<double, art::Ptr<recob::Hit>>& a,
+                         const std::pair<double, art::Ptr<recob::Hit>>& b) {
+    return a.first == b.first;
+  };
+  std::stable_sort(hits.begin(), hits.end(), byDistance);
+  hits.erase(std::unique(hits.begin(), hits.end(), sameDistance), hits.end());
+}
+
 void mvapid::MVAAlg::FitAndSortTrack(art::Ptr<recob::Track> track,
                                      int& isStoppingReco,
                                      mvapid::MVAAlg::SortedObj& sortedTrack)
 {
 
-  sortedTrack.hitMap.clear();
+  sortedTrack.sortedHits.clear();
   TVector3 trackPoint, trackDir;
   this->LinFit(track, trackPoint, trackDir);
 
@@ -405,18 +488,20 @@ void mvapid::MVAAlg::FitAndSortTrack(art::Ptr<recob::Track> track,
   sortedTrack.dir = trackDir;
   sortedTrack.length = (nearestPointEnd - nearestPointStart).Mag();
 
-  std::vector<art::Ptr<recob::Hit>> hits = fTracksToHits[track];
+  const std::vector<art::Ptr<recob::Hit>>& hits = fTracksToHits[track.key()];
+  sortedTrack.sortedHits.reserve(hits.size());
 
   for (auto hitIter = hits.begin(); hitIter != hits.end(); ++hitIter) {
 
-    if (!fHitsToSpacePoints.count(*hitIter)) continue;
-    art::Ptr<recob::SpacePoint> sp = fHitsToSpacePoints.at(*hitIter);
+    art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(*hitIter);
+    if (sp.isNull()) continue;
 
     TVector3 nearestPoint =
       trackPoint + trackDir * (trackDir.Dot(TVector3(sp->XYZ()) - trackPoint) / trackDir.Mag2());
     double lengthAlongTrack = (nearestPointStart - nearestPoint).Mag();
-    sortedTrack.hitMap.insert(std::pair<double, art::Ptr<recob::Hit>>(lengthAlongTrack, *hitIter));
+    sortedTrack.sortedHits.emplace_back(lengthAlongTrack, *hitIter);
   }
+  SortHitsByDistance(sortedTrack.sortedHits);
 }
 
 //void mvapid::MVAAlg::SortShower(art::Ptr<recob::Shower> shower,TVector3 dir,int& isStoppingReco,
@@ -425,16 +510,16 @@ void mvapid::MVAAlg::SortShower(art::Ptr<recob::Shower> shower,
                                 int& isStoppingReco,
                                 mvapid::MVAAlg::SortedObj& sortedShower)
 {
-  sortedShower.hitMap.clear();
+  sortedShower.sortedHits.clear();
 
-  std::vector<art::Ptr<recob::Hit>> hits = fShowersToHits[shower];
+  const std::vector<art::Ptr<recob::Hit>>& hits = fShowersToHits[shower.key()];
 
   TVector3 showerEnd(0, 0, 0);
   double furthestHitFromStart = -999.9;
   for (auto hitIter = hits.begin(); hitIter != hits.end(); ++hitIter) {
 
-    if (!fHitsToSpacePoints.count(*hitIter)) continue;
-    art::Ptr<recob::SpacePoint> sp = fHitsToSpacePoints.at(*hitIter);
+    art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(*hitIter);
+    if (sp.isNull()) continue;
     if ((TVector3(sp->XYZ()) - shower->ShowerStart()).Mag() > furthestHitFromStart) {
       showerEnd = TVector3(sp->XYZ());
       furthestHitFromStart = (TVector3(sp->XYZ()) - shower->ShowerStart()).Mag();
@@ -498,18 +583,19 @@ void mvapid::MVAAlg::SortShower(art::Ptr<recob::Shower> shower,
   sortedShower.dir = showerDir;
   sortedShower.length = (nearestPointEnd - nearestPointStart).Mag();
 
+  sortedShower.sortedHits.reserve(hits.size());
   for (auto hitIter = hits.begin(); hitIter != hits.end(); ++hitIter) {
 
-    if (!fHitsToSpacePoints.count(*hitIter)) continue;
-    art::Ptr<recob::SpacePoint> sp = fHitsToSpacePoints.at(*hitIter);
+    art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(*hitIter);
+    if (sp.isNull()) continue;
 
     TVector3 nearestPoint =
       showerPoint +
       showerDir * (showerDir.Dot(TVector3(sp->XYZ()) - showerPoint) / showerDir.Mag2());
     double lengthAlongShower = (nearestPointStart - nearestPoint).Mag();
-    sortedShower.hitMap.insert(
-      std::pair<double, art::Ptr<recob::Hit>>(lengthAlongShower, *hitIter));
+    sortedShower.sortedHits.emplace_back(lengthAlongShower, *hitIter);
   }
+  SortHitsByDistance(sortedShower.sortedHits);
 }
 void mvapid::MVAAlg::RunPCA(std::vector<art::Ptr<recob::Hit>>& hits,
                             std::vector<double>& eVals,
@@ -519,9 +605,8 @@ void mvapid::MVAAlg::RunPCA(std::vector<art::Ptr<recob::Hit>>& hits,
 
   for (auto hitIter = hits.begin(); hitIter != hits.end(); ++hitIter) {
 
-    if (fHitsToSpacePoints.count(*hitIter)) {
-      principal->AddRow(fHitsToSpacePoints.at(*hitIter)->XYZ());
-    }
+    art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(*hitIter);
+    if (sp.isNonnull()) { principal->AddRow(sp->XYZ()); }
   }
 
   // PERFORM PCA
@@ -562,9 +647,9 @@ void mvapid::MVAAlg::_Var_Shape(const mvapid::MVAAlg::SortedObj& track,
   unsigned int nHitsConStart = 0;
   unsigned int nHitsConEnd = 0;
 
-  for (auto hitIter = track.hitMap.begin(); hitIter != track.hitMap.end(); ++hitIter) {
-    if (fHitsToSpacePoints.count(hitIter->second)) {
-      art::Ptr<recob::SpacePoint> sp = fHitsToSpacePoints.at(hitIter->second);
+  for (auto hitIter = track.sortedHits.begin(); hitIter != track.sortedHits.end(); ++hitIter) {
+    art::Ptr<recob::SpacePoint> sp = this->SpacePointOf(hitIter->second);
+    if (sp.isNonnull()) {
 
       double distFromTrackFit = ((TVector3(sp->XYZ()) - track.start).Cross(track.dir)).Mag();
 
@@ -636,9 +721,14 @@ double mvapid::MVAAlg::CalcSegmentdEdxDist(const detinfo::DetectorClocksData& cl
   unsigned int nHits = 0;
 
   //Loop over hits again to calculate average dE/dx and shape variables
-  for (auto hitIter = track.hitMap.begin(); hitIter != track.hitMap.end(); ++hitIter) {
+  //Hits are sorted by distance, so skip straight to the start of the segment
+  auto beforeSegment = [](const std::pair<double, art::Ptr<recob::Hit>>& hit, double dist) {
+    return hit.first < dist;
+  };
+  auto hitIter =
+    std::lower_bound(track.sortedHits.begin(), track.sortedHits.end(), start, beforeSegment);
+  for (; hitIter != track.sortedHits.end(); ++hitIter) {
 
-    if (hitIter->first < start) continue;
     if (hitIter->first >= end) break;
 
     art::Ptr<recob::Hit> hit = hitIter->second;
@@ -679,7 +769,7 @@ int mvapid::MVAAlg::LinFit(const art::Ptr<recob::Track> track,
                            TVector3& trackDir)
 {
 
-  const std::vector<art::Ptr<recob::SpacePoint>>& sp = fTracksToSpacePoints.at(track);
+  const std::vector<art::Ptr<recob::SpacePoint>>& sp = fTracksToSpacePoints.at(track.key());
 
   TGraph2D grFit(1);
   unsigned int iPt = 0;
@@ -729,7 +819,7 @@ int mvapid::MVAAlg::LinFitShower(const art::Ptr<recob::Shower> shower,
                                  TVector3& showerDir)
 {
 
-  const std::vector<art::Ptr<recob::SpacePoint>>& sp = fShowersToSpacePoints.at(shower);
+  const std::vector<art::Ptr<recob::SpacePoint>>& sp = fShowersToSpacePoints.at(shower.key());
 
   TGraph2D grFit(1);
   unsigned int iPt = 0;
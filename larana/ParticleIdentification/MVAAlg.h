@@ -5,8 +5,10 @@
 #ifndef MVAAlg_H
 #define MVAAlg_H
 
+#include <cstddef>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace art {
@@ -46,7 +48,8 @@ namespace mvapid {
     struct SortedObj {
       TVector3 start, end, dir;
       double length;
-      std::map<double, const art::Ptr<recob::Hit>> hitMap;
+      /// Hits with a space point, sorted by distance along the fitted axis
+      std::vector<std::pair<double, art::Ptr<recob::Hit>>> sortedHits;
     };
 
     struct SumDistance2 {
@@ -92,6 +95,14 @@ namespace mvapid {
 
     void PrepareEvent(const art::Event& event, const detinfo::DetectorClocksData& clockData);
 
+    /// Space point associated with the hit, or a null pointer if there is none
+    art::Ptr<recob::SpacePoint> SpacePointOf(const art::Ptr<recob::Hit>& hit) const;
+
+    /// Sorts the hits by distance and drops repeated distances, keeping the first one
+    static void SortHitsByDistance(std::vector<std::pair<double, art::Ptr<recob::Hit>>>& hits);
+
+    void EvaluateMVAs(std::vector<anab::MVAPIDResult>& results, std::size_t first);
+
     void FitAndSortTrack(art::Ptr<recob::Track> track, int& isStoppingReco, SortedObj& sortedObj);
 
     //void SortShower(art::Ptr<recob::Shower> shower,TVector3 dir,int& isStoppingReco,
@@ -152,13 +163,16 @@ namespace mvapid {
     std::vector<art::Ptr<recob::SpacePoint>> fSpacePoints;
     std::vector<art::Ptr<recob::Hit>> fHits;
 
-    std::map<art::Ptr<recob::Track>, std::vector<art::Ptr<recob::Hit>>> fTracksToHits;
-    std::map<art::Ptr<recob::Track>, std::vector<art::Ptr<recob::SpacePoint>>> fTracksToSpacePoints;
-    std::map<art::Ptr<recob::Shower>, std::vector<art::Ptr<recob::Hit>>> fShowersToHits;
-    std::map<art::Ptr<recob::Shower>, std::vector<art::Ptr<recob::SpacePoint>>>
-      fShowersToSpacePoints;
-    std::map<art::Ptr<recob::Hit>, art::Ptr<recob::SpacePoint>> fHitsToSpacePoints;
-    std::map<art::Ptr<recob::SpacePoint>, art::Ptr<recob::Hit>> fSpacePointsToHits;
+    // Associations indexed by the key of the track, shower, space point or hit
+    std::vector<std::vector<art::Ptr<recob::Hit>>> fTracksToHits;
+    std::vector<std::vector<art::Ptr<recob::SpacePoint>>> fTracksToSpacePoints;
+    std::vector<std::vector<art::Ptr<recob::Hit>>> fShowersToHits;
+    std::vector<std::vector<art::Ptr<recob::SpacePoint>>> fShowersToSpacePoints;
+    std::vector<art::Ptr<recob::SpacePoint>> fHitsToSpacePoints;
+    std::vector<art::Ptr<recob::Hit>> fSpacePointsToHits;
+    art::ProductID fSpacePointHitsID; ///< product of the hits in fHitsToSpacePoints
+    /// Space points of the hits from any other product
+    std::map<art::Ptr<recob::Hit>, art::Ptr<recob::SpacePoint>> fOtherHitsToSpacePoints;
 
     anab::MVAPIDResult fResHolder;
 
@@ -166,6 +180,7 @@ namespace mvapid {
 
     std::vector<std::string> fMVAMethods;
     std::vector<std::string> fWeightFiles;
+    std::vector<TMVA::MethodBase*> fMVAMethodPtrs; ///< booked methods, owned by fReader
 
     bool fCheatVertex;
 
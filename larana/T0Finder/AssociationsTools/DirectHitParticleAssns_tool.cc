@@ -15,6 +15,9 @@
 
 #include "nusimdata/SimulationBase/MCParticle.h"
 
+#include <cstdlib>
+#include <unordered_map>
+
 namespace t0 {
   ////////////////////////////////////////////////////////////////////////
   //
@@ -109,6 +112,17 @@ namespace t0 {
 
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
 
+    // Index the MCParticles by their track ID once for all the hits; the first particle
+    // with a given track ID is the one kept
+    auto const& mcpartList(*mcpartHandle);
+    std::unordered_map<int, int>
+      trkid_lookup; //indexed by geant4trkid, delivers MC particle location
+
+    trkid_lookup.reserve(mcpartList.size());
+
+    for (size_t i_p = 0; i_p < mcpartList.size(); ++i_p)
+      trkid_lookup.emplace(mcpartList[i_p].TrackId(), (int)i_p);
+
     // Loop over input hit producer labels
     for (const auto& inputTag : fHitModuleLabelVec) {
       art::Handle<std::vector<recob::Hit>> hitListHandle;
@@ -121,11 +135,8 @@ namespace t0 {
       }
 
       anab::BackTrackerHitMatchingData bthmd;
-      std::unordered_map<int, int>
-        trkid_lookup; //indexed by geant4trkid, delivers MC particle location
 
       auto const& hitList(*hitListHandle);
-      auto const& mcpartList(*mcpartHandle);
 
       for (size_t i_h = 0; i_h < hitList.size(); ++i_h) {
         art::Ptr<recob::Hit> hitPtr(hitListHandle, i_h);
@@ -144,38 +155,27 @@ namespace t0 {
         //for(auto const& t : trkide_list){
         for (size_t i_t = 0; i_t < trkide_list.size(); ++i_t) {
           auto const& t(trkide_list[i_t]);
-          fTrkIDECollector[t.trackID].E += t.energy;
+          auto& trkIDE(fTrkIDECollector[t.trackID]);
+          trkIDE.E += t.energy;
           tote += t.energy;
-          if (fTrkIDECollector[t.trackID].E > maxe) {
-            maxe = fTrkIDECollector[t.trackID].E;
+          if (trkIDE.E > maxe) {
+            maxe = trkIDE.E;
             maxtrkid = t.trackID;
           }
-          fTrkIDECollector[t.trackID].NumElectrons += t.numElectrons;
+          trkIDE.NumElectrons += t.numElectrons;
           totn += t.numElectrons;
-          if (fTrkIDECollector[t.trackID].NumElectrons > maxn) {
-            maxn = fTrkIDECollector[t.trackID].NumElectrons;
+          if (trkIDE.NumElectrons > maxn) {
+            maxn = trkIDE.NumElectrons;
             maxntrkid = t.trackID;
           }
-
-          //if not found, find mc particle...
-          if (trkid_lookup.find(t.trackID) == trkid_lookup.end()) {
-            size_t i_p = 0;
-            while (i_p < mcpartList.size()) {
-              if (mcpartList[i_p].TrackId() == abs(t.trackID)) {
-                trkid_lookup[t.trackID] = (int)i_p;
-                break;
-              }
-              ++i_p;
-            }
-            if (i_p == mcpartList.size()) trkid_lookup[t.trackID] = -1;
-          }
         }
         //end loop on TrackIDs
 
         //now find the mcparticle and loop back through ...
         for (auto const& t : fTrkIDECollector) {
-          int mcpart_i = trkid_lookup[t.first];
-          if (mcpart_i == -1) continue; //no mcparticle here
+          auto const mcpartItr = trkid_lookup.find(std::abs(t.first));
+          if (mcpartItr == trkid_lookup.end()) continue; //no mcparticle here
+          int mcpart_i = mcpartItr->second;
           art::Ptr<simb::MCParticle> mcpartPtr(mcpartHandle, mcpart_i);
           bthmd.ideFraction = t.second.E / tote;
           bthmd.isMaxIDE = (t.first == maxtrkid);
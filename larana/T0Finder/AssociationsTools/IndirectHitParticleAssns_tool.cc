@@ -12,6 +12,24 @@
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+  // The ticks of a hit run from its truncated start time up to its end time included
+  raw::TDCtick_t TickRangeStart(const recob::Hit& hit)
+  {
+    return static_cast<raw::TDCtick_t>(hit.PeakTimeMinusRMS());
+  }
+  raw::TDCtick_t TickRangeEnd(const recob::Hit& hit)
+  {
+    return static_cast<raw::TDCtick_t>(std::floor(hit.PeakTimePlusRMS()));
+  }
+}
+
 namespace t0 {
   ////////////////////////////////////////////////////////////////////////
   //
@@ -110,6 +128,53 @@ namespace t0 {
         << "/" << evt.subRun() << "/" << evt.id().event();
     }
 
+    // Go through the associations and build out our (hopefully sparse) data structure: for each
+    // channel, the tick intervals of the associated hits sorted by their first tick. It does not
+    // depend on the hit collection being processed so it is built only once
+    using ParticleDataPair = std::pair<size_t, const anab::BackTrackerHitMatchingData*>;
+
+    struct TickInterval {
+      raw::TDCtick_t firstTick;
+      raw::TDCtick_t lastTick;
+      ParticleDataPair partData;
+    };
+
+    struct ChannelIntervals {
+      std::vector<TickInterval> intervals;
+      raw::TDCtick_t maxWidth = 0; ///< largest lastTick - firstTick on the channel
+    };
+
+    using ChannelToIntervalsMap = std::unordered_map<raw::ChannelID_t, ChannelIntervals>;
+
+    ChannelToIntervalsMap chanToIntervalsMap;
+
+    // Build out the maps between hits/particles
+    for (HitParticleAssociations::const_iterator partHitItr = partHitAssnsHandle->begin();
+         partHitItr != partHitAssnsHandle->end();
+         ++partHitItr) {
+      const art::Ptr<simb::MCParticle>& mcParticle = partHitItr->first;
+      const art::Ptr<recob::Hit>& recoHit = partHitItr->second;
+      const anab::BackTrackerHitMatchingData* data = &partHitAssnsHandle->data(partHitItr);
+
+      ChannelIntervals& channelIntervals = chanToIntervalsMap[recoHit->Channel()];
+
+      TickInterval interval{
+        TickRangeStart(*recoHit), TickRangeEnd(*recoHit), ParticleDataPair(mcParticle.key(), data)};
+
+      if (interval.lastTick < interval.firstTick) continue;
+
+      channelIntervals.intervals.push_back(interval);
+      channelIntervals.maxWidth =
+        std::max(channelIntervals.maxWidth, interval.lastTick - interval.firstTick);
+    }
+
+    for (auto& chanIntervals : chanToIntervalsMap)
+      std::sort(chanIntervals.second.intervals.begin(),
+                chanIntervals.second.intervals.end(),
+                [](const TickInterval& left, const TickInterval& right) {
+                  return left.firstTick < right.firstTick;
+                });
+
     // Loop over input hit collections
     for (const auto& inputTag : fHitModuleLabelVec) {
       // Look up the hits we want to process as well, since if they are not there then no point in proceeding
@@ -123,58 +188,53 @@ namespace t0 {
         continue;
       }
 
-      // Go through the associations and build out our (hopefully sparse) data structure
-      using ParticleDataPair = std::pair<size_t, const anab::BackTrackerHitMatchingData*>;
-      using MCParticleDataSet = std::set<ParticleDataPair>;
-      using TickToPartDataMap = std::unordered_map<raw::TDCtick_t, MCParticleDataSet>;
-      using ChannelToTickPartDataMap = std::unordered_map<raw::ChannelID_t, TickToPartDataMap>;
-
-      ChannelToTickPartDataMap chanToTickPartDataMap;
-
-      // Build out the maps between hits/particles
-      for (HitParticleAssociations::const_iterator partHitItr = partHitAssnsHandle->begin();
-           partHitItr != partHitAssnsHandle->end();
-           ++partHitItr) {
-        const art::Ptr<simb::MCParticle>& mcParticle = partHitItr->first;
-        const art::Ptr<recob::Hit>& recoHit = partHitItr->second;
-        const anab::BackTrackerHitMatchingData* data = &partHitAssnsHandle->data(partHitItr);
-
-        TickToPartDataMap& tickToPartDataMap = chanToTickPartDataMap[recoHit->Channel()];
-
-        for (raw::TDCtick_t tick = recoHit->PeakTimeMinusRMS(); tick <= recoHit->PeakTimePlusRMS();
-             tick++) {
-          tickToPartDataMap[tick].insert(ParticleDataPair(mcParticle.key(), data));
-        }
-      }
+      // Keep track of results
+      std::vector<ParticleDataPair> particleDataVec;
 
       // Armed with the map, process the hit list
       for (size_t hitIdx = 0; hitIdx < hitListHandle->size(); hitIdx++) {
         art::Ptr<recob::Hit> hit(hitListHandle, hitIdx);
 
-        TickToPartDataMap& tickToPartDataMap = chanToTickPartDataMap[hit->Channel()];
+        ChannelToIntervalsMap::const_iterator chanItr = chanToIntervalsMap.find(hit->Channel());
 
-        if (tickToPartDataMap.empty()) {
+        if (chanItr == chanToIntervalsMap.end() || chanItr->second.intervals.empty()) {
           mf::LogInfo("IndirectHitParticleAssns")
             << "No channel information found for hit " << hit << "\n";
           continue;
         }
 
-        // Keep track of results
-        MCParticleDataSet particleDataSet;
+        const std::vector<TickInterval>& intervals = chanItr->second.intervals;
 
-        // Go through the ticks in this hit and recover associations
-        for (raw::TDCtick_t tick = hit->PeakTimeMinusRMS(); tick <= hit->PeakTimePlusRMS();
-             tick++) {
-          TickToPartDataMap::iterator hitInfoItr = tickToPartDataMap.find(tick);
+        raw::TDCtick_t firstTick = TickRangeStart(*hit);
+        raw::TDCtick_t lastTick = TickRangeEnd(*hit);
 
-          if (hitInfoItr != tickToPartDataMap.end()) {
-            for (const auto& partData : hitInfoItr->second)
-              particleDataSet.insert(partData);
+        particleDataVec.clear();
+
+        // Only the intervals starting within maxWidth before the hit can reach it, sweep through
+        // them and keep those overlapping any tick of the hit
+        if (firstTick <= lastTick) {
+          std::vector<TickInterval>::const_iterator intervalItr = std::lower_bound(
+            intervals.begin(),
+            intervals.end(),
+            firstTick - chanItr->second.maxWidth,
+            [](const TickInterval& interval, raw::TDCtick_t tick) {
+              return interval.firstTick < tick;
+            });
+
+          for (; intervalItr != intervals.end() && intervalItr->firstTick <= lastTick;
+               intervalItr++) {
+            if (intervalItr->lastTick >= firstTick)
+              particleDataVec.push_back(intervalItr->partData);
           }
         }
 
+        // Same ordering, and no duplicates, as a std::set of the pairs
+        std::sort(particleDataVec.begin(), particleDataVec.end());
+        particleDataVec.erase(std::unique(particleDataVec.begin(), particleDataVec.end()),
+                              particleDataVec.end());
+
         // Now create new associations for the hit in question
-        for (const auto& partData : particleDataSet)
+        for (const auto& partData : particleDataVec)
           hitPartAssns->addSingle(
             art::Ptr<simb::MCParticle>(mcParticleHandle, partData.first), hit, *partData.second);
       }
@@ -55,6 +55,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <vector>
 
 // LArSoft
 #include "larcore/Geometry/Geometry.h"
@@ -97,6 +98,11 @@ public:
   void beginJob() override;
 
 private:
+  // BackTracker TrackIDEs of a hit, computed once per event and hit
+  const std::vector<sim::TrackIDE>& HitToTrackIDEs(cheat::BackTrackerService const& bt_serv,
+                                                   detinfo::DetectorClocksData const& clockData,
+                                                   art::Ptr<recob::Hit> const& hit);
+
   // Params got from fcl file
   art::InputTag fTrackModuleLabel;
   art::InputTag fShowerModuleLabel;
@@ -109,6 +115,14 @@ private:
 
   bool fOverrideRealData;
 
+  // Per-event memo of the BackTracker results, indexed by hit key for each hit collection,
+  // shared by the hit, track, shower and PFParticle matching
+  struct HitTrackIDEsMemo {
+    std::vector<std::vector<sim::TrackIDE>> trackIDEs;
+    std::vector<bool> filled;
+  };
+  std::map<art::ProductID, HitTrackIDEsMemo> fHitTrackIDEsMemo;
+
   // Variable in TFS branches
   TTree* fTree;
   int TrackID = 0;
@@ -179,6 +193,9 @@ void t0::MCTruthT0Matching::produce(art::Event& evt)
   art::ServiceHandle<cheat::ParticleInventoryService const> pi_serv;
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
 
+  // The BackTracker results of the previous event do not apply any more
+  fHitTrackIDEsMemo.clear();
+
   //TrackList handle
   art::Handle<std::vector<recob::Track>> trackListHandle;
   std::vector<art::Ptr<recob::Track>> tracklist;
@@ -246,7 +263,7 @@ void t0::MCTruthT0Matching::produce(art::Event& evt)
       auto const& mcpartList(*mcpartHandle);
       for (size_t i_h = 0; i_h < hitList.size(); ++i_h) {
         art::Ptr<recob::Hit> hitPtr(hitListHandle, i_h);
-        auto trkide_list = bt_serv->HitToTrackIDEs(clockData, hitPtr);
+        auto const& trkide_list = HitToTrackIDEs(*bt_serv, clockData, hitPtr);
         struct TrackIDEinfo {
           float E;
           float NumElectrons;
@@ -322,8 +339,7 @@ void t0::MCTruthT0Matching::produce(art::Event& evt)
       std::map<int, double> trkide;
       for (size_t h = 0; h < allHits.size(); ++h) {
         art::Ptr<recob::Hit> hit = allHits[h];
-        std::vector<sim::IDE> ides;
-        std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
+        std::vector<sim::TrackIDE> const& TrackIDs = HitToTrackIDEs(*bt_serv, clockData, hit);
 
         for (size_t e = 0; e < TrackIDs.size(); ++e) {
           trkide[TrackIDs[e].trackID] += TrackIDs[e].energy;
@@ -386,8 +402,7 @@ void t0::MCTruthT0Matching::produce(art::Event& evt)
       std::map<int, double> showeride;
       for (size_t h = 0; h < allHits.size(); ++h) {
         art::Ptr<recob::Hit> hit = allHits[h];
-        std::vector<sim::IDE> ides;
-        std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
+        std::vector<sim::TrackIDE> const& TrackIDs = HitToTrackIDEs(*bt_serv, clockData, hit);
 
         for (size_t e = 0; e < TrackIDs.size(); ++e) {
           showeride[TrackIDs[e].trackID] += TrackIDs[e].energy;
@@ -458,8 +473,7 @@ void t0::MCTruthT0Matching::produce(art::Event& evt)
       std::map<int, double> trkide;
       for (size_t h = 0; h < allHits.size(); ++h) {
         art::Ptr<recob::Hit> hit = allHits[h];
-        std::vector<sim::IDE> ides;
-        std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
+        std::vector<sim::TrackIDE> const& TrackIDs = HitToTrackIDEs(*bt_serv, clockData, hit);
 
         for (size_t e = 0; e < TrackIDs.size(); ++e) {
           trkide[TrackIDs[e].trackID] += TrackIDs[e].energy;
@@ -530,4 +544,24 @@ void t0::MCTruthT0Matching::produce(art::Event& evt)
   if (fMakeHitAssns) evt.put(std::move(MCPartHitassn));
 } // Produce
 
+const std::vector<sim::TrackIDE>& t0::MCTruthT0Matching::HitToTrackIDEs(
+  cheat::BackTrackerService const& bt_serv,
+  detinfo::DetectorClocksData const& clockData,
+  art::Ptr<recob::Hit> const& hit)
+{
+  HitTrackIDEsMemo& memo = fHitTrackIDEsMemo[hit.id()];
+
+  if (hit.key() >= memo.filled.size()) {
+    memo.trackIDEs.resize(hit.key() + 1);
+    memo.filled.resize(hit.key() + 1, false);
+  }
+
+  if (!memo.filled[hit.key()]) {
+    memo.trackIDEs[hit.key()] = bt_serv.HitToTrackIDEs(clockData, hit);
+    memo.filled[hit.key()] = true;
+  }
+
+  return memo.trackIDEs[hit.key()];
+}
+
 DEFINE_ART_MODULE(t0::MCTruthT0Matching)
@@ -41,6 +41,7 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 // LArSoft
 #include "larcore/Geometry/Geometry.h"
@@ -99,12 +100,8 @@ private:
                  double& trkTimeLengh,
                  double& trkTimeCentre,
                  double& TrackLength);
-  double DistFromPoint(double StartY,
-                       double EndY,
-                       double StartZ,
-                       double EndZ,
-                       double PointY,
-                       double PointZ);
+  void PackTrackSegments(recob::Track const& track);
+  double MinDistFromPoint(double PointY, double PointZ) const;
 
   // Params got from fcl file.......
   std::string fTrackModuleLabel;
@@ -141,6 +138,22 @@ private:
   int FlashTriggerType = 1;
 
   double YZSep, MCTruthT0;
+
+  // Flash quantities which do not depend on the track, computed once per event
+  struct FlashInfo {
+    double Time;       ///< in us
+    bool AboveThreshold;
+    double PredictedX; ///< from the PE count, in cm
+    double YCenter, ZCenter;
+  };
+  std::vector<FlashInfo> fFlashInfo;
+
+  // YZ segments between adjacent trajectory points of the current track, one array per
+  // quantity so the distance loop runs over contiguous memory
+  std::vector<double> fSegStartY, fSegStartZ; ///< the later point of each pair
+  std::vector<double> fSegDeltaY, fSegDeltaZ; ///< earlier minus later point
+  std::vector<double> fSegLength;
+
   // Histograms in TFS branches
   TTree* fTree;
   TH2D* hPredX_T;
@@ -323,6 +336,26 @@ void lbne::PhotonCounterT0Matching::produce(art::Event& evt)
       std::cout << "There were " << NTracks << " tracks and " << NFlashes
                 << " flashes in this event." << std::endl;
 
+    const double DriftWindow = fDriftWindowSize / clock_data.TPCClock().Frequency(); // in us
+    const double DriftVelocity = detprop.DriftVelocity();
+
+    fFlashInfo.clear();
+    for (size_t iFlash = 0; iFlash < NFlashes; ++iFlash) {
+      const recob::OpFlash& flash = *flashlist[iFlash];
+      FlashInfo info;
+      info.Time = flash.Time(); // Got in us!
+      info.AboveThreshold = !(flash.TotalPE() < fPEThreshold);
+      info.PredictedX = 9999;
+      // PredictedX = ( A / x^n ) + exp ( B + Cx )
+      if (info.AboveThreshold)
+        info.PredictedX =
+          (fPredictedXConstant / pow(flash.TotalPE(), fPredictedXPower)) +
+          (exp(fPredictedExpConstant + (fPredictedExpGradient * flash.TotalPE())));
+      info.YCenter = flash.YCenter();
+      info.ZCenter = flash.ZCenter();
+      fFlashInfo.push_back(info);
+    }
+
     // Now to access PhotonCounter for each track...
     for (size_t iTrk = 0; iTrk < NTracks; ++iTrk) {
       if (fVerbosity) std::cout << "\n New Track " << (int)iTrk << std::endl;
@@ -369,41 +402,34 @@ void lbne::PhotonCounterT0Matching::produce(art::Event& evt)
                   << trkTimeStart << " " << trkTimeEnd << " " << trkTimeLengh << " "
                   << trkTimeCentre << std::endl;
       }
+      // The track segments are only packed once a flash is found in its drift window
+      bool SegmentsPacked = false;
+
       // ----- Loop over flashes ------
       for (size_t iFlash = 0; iFlash < NFlashes; ++iFlash) {
+        const FlashInfo& flash = fFlashInfo[iFlash];
         //Reset some flash specific quantities
         YZSep = minYZSep = 9999;
         FlashTime = TimeSep = 9999;
         PredictedX = TimeSepPredX = DeltaPredX = FitParam = 9999;
         // Check flash could be caused by track...
-        FlashTime = flashlist[iFlash]->Time(); // Got in us!
-        TimeSep = trkTimeCentre - FlashTime;   // Time in us!
-        if (TimeSep < 0 || TimeSep > (fDriftWindowSize / clock_data.TPCClock().Frequency()))
-          continue; // Times compared in us!
+        FlashTime = flash.Time;              // Got in us!
+        TimeSep = trkTimeCentre - FlashTime; // Time in us!
+        if (TimeSep < 0 || TimeSep > DriftWindow) continue; // Times compared in us!
 
         // Check flash has enough PE's to satisfy our threshold
-        if (flashlist[iFlash]->TotalPE() < fPEThreshold) continue;
+        if (!flash.AboveThreshold) continue;
 
         // Work out some quantities for this flash...
-        // PredictedX = ( A / x^n ) + exp ( B + Cx )
-        PredictedX =
-          (fPredictedXConstant / pow(flashlist[iFlash]->TotalPE(), fPredictedXPower)) +
-          (exp(fPredictedExpConstant + (fPredictedExpGradient * flashlist[iFlash]->TotalPE())));
-        TimeSepPredX = TimeSep * detprop.DriftVelocity(); // us * cm/us = cm!
+        PredictedX = flash.PredictedX;
+        TimeSepPredX = TimeSep * DriftVelocity; // us * cm/us = cm!
         DeltaPredX = fabs(TimeSepPredX - PredictedX);
         // Dependant on each point...
-        for (size_t Point = 1; Point < tracklist[iTrk]->NumberTrajectoryPoints(); ++Point) {
-          auto NewPoint = tracklist[iTrk]->LocationAtPoint(Point);
-          auto PrevPoint = tracklist[iTrk]->LocationAtPoint(Point - 1);
-          YZSep = DistFromPoint(NewPoint.Y(),
-                                PrevPoint.Y(),
-                                NewPoint.Z(),
-                                PrevPoint.Z(),
-                                flashlist[iFlash]->YCenter(),
-                                flashlist[iFlash]->ZCenter());
-          if (Point == 1) minYZSep = YZSep;
-          if (YZSep < minYZSep) minYZSep = YZSep;
+        if (!SegmentsPacked) {
+          PackTrackSegments(*tracklist[iTrk]);
+          SegmentsPacked = true;
         }
+        minYZSep = MinDistFromPoint(flash.YCenter, flash.ZCenter);
 
         // Determine how well matched this track is......
         if (fMatchCriteria == 0)
@@ -519,18 +545,42 @@ void lbne::PhotonCounterT0Matching::TrackProp(double TrackStart_X,
   return;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
-double lbne::PhotonCounterT0Matching::DistFromPoint(double StartY,
-                                                    double EndY,
-                                                    double StartZ,
-                                                    double EndZ,
-                                                    double PointY,
-                                                    double PointZ)
+void lbne::PhotonCounterT0Matching::PackTrackSegments(recob::Track const& track)
 {
-  ///Calculate the distance between the centre of the flash and the centre of a line connecting two adjacent space points.
-  double Length = hypot(fabs(EndY - StartY), fabs(EndZ - StartZ));
-  double distance =
-    ((PointZ - StartZ) * (EndY - StartY) - (PointY - StartY) * (EndZ - StartZ)) / Length;
-  return fabs(distance);
+  ///Store the lines connecting adjacent space points of the track in YZ.
+  fSegStartY.clear();
+  fSegStartZ.clear();
+  fSegDeltaY.clear();
+  fSegDeltaZ.clear();
+  fSegLength.clear();
+
+  for (size_t Point = 1; Point < track.NumberTrajectoryPoints(); ++Point) {
+    auto NewPoint = track.LocationAtPoint(Point);
+    auto PrevPoint = track.LocationAtPoint(Point - 1);
+    double DeltaY = PrevPoint.Y() - NewPoint.Y();
+    double DeltaZ = PrevPoint.Z() - NewPoint.Z();
+    fSegStartY.push_back(NewPoint.Y());
+    fSegStartZ.push_back(NewPoint.Z());
+    fSegDeltaY.push_back(DeltaY);
+    fSegDeltaZ.push_back(DeltaZ);
+    fSegLength.push_back(hypot(fabs(DeltaY), fabs(DeltaZ)));
+  }
+
+  return;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+double lbne::PhotonCounterT0Matching::MinDistFromPoint(double PointY, double PointZ) const
+{
+  ///Calculate the smallest distance between the centre of the flash and the lines connecting two adjacent space points.
+  double minDistance = 9999;
+  const size_t NSegments = fSegLength.size();
+  for (size_t Seg = 0; Seg < NSegments; ++Seg) {
+    double distance = fabs(((PointZ - fSegStartZ[Seg]) * fSegDeltaY[Seg] -
+                            (PointY - fSegStartY[Seg]) * fSegDeltaZ[Seg]) /
+                           fSegLength[Seg]);
+    if (Seg == 0 || distance < minDistance) minDistance = distance;
+  }
+  return minDistance;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
 DEFINE_ART_MODULE(lbne::PhotonCounterT0Matching)
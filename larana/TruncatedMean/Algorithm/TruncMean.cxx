@@ -13,43 +13,236 @@ float TruncMean::CalcIterativeTruncMean(std::vector<float> v,
                                         const float& nsigma,
                                         const float& oldmed)
 {
+  return CalcIterativeTruncMeanInPlace(
+    v, nmin, nmax, currentiteration, lmin, convergencelimit, nsigma, oldmed);
+}
+
+float TruncMean::CalcIterativeTruncMeanInPlace(std::vector<float>& v,
+                                               const size_t& nmin,
+                                               const size_t& nmax,
+                                               const size_t& currentiteration,
+                                               const size_t& lmin,
+                                               const float& convergencelimit,
+                                               const float& nsigma,
+                                               const float& oldmed)
+{
+
+  size_t iteration = currentiteration;
+  size_t limit = lmin;
+  float lastmed = oldmed;
 
-  auto const& mean = Mean(v);
-  auto const& med = Median(v);
-  auto const& rms = RMS(v);
+  while (true) {
 
-  // if the vector length is below the lower limit -> return
-  if (v.size() < lmin) return mean;
+    auto const mean = Mean(v);
 
-  // if we have passed the maximum number of iterations -> return
-  if (currentiteration >= nmax) return mean;
+    // if the vector length is below the lower limit -> return
+    if (v.empty() || v.size() < limit) return mean;
 
-  // if we passed the minimum number of iterations and the mean is close enough to the old value
-  float fracdiff = fabs(med - oldmed) / oldmed;
-  if ((currentiteration >= nmin) && (fracdiff < convergencelimit)) return mean;
+    // if we have passed the maximum number of iterations -> return
+    if (iteration >= nmax) return mean;
 
-  // if reached here it means we have to go on for another iteration
+    // mean and rms are taken before the median partitions the buffer
+    auto const rms = RMS(v);
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    auto const med = v[v.size() / 2];
 
-  // cutoff tails of distribution surrounding the mean
-  // use erase-remove : https://en.wikipedia.org/wiki/Erase%E2%80%93remove_idiom
-  // https://stackoverflow.com/questions/17270837/stdvector-removing-elements-which-fulfill-some-conditions
-  v.erase(std::remove_if(v.begin(),
-                         v.end(),
-                         [med, nsigma, rms](const float& x) {
-                           return ((x < (med - nsigma * rms)) || (x > (med + nsigma * rms)));
-                         }), // lamdda condition for events to be removed
-          v.end());
+    // if we passed the minimum number of iterations and the mean is close enough to the old value
+    float fracdiff = fabs(med - lastmed) / lastmed;
+    if ((iteration >= nmin) && (fracdiff < convergencelimit)) return mean;
 
-  return CalcIterativeTruncMean(
-    v, nmin, nmax, lmin, currentiteration + 1, convergencelimit, nsigma, med);
+    // if reached here it means we have to go on for another iteration
+
+    // cutoff tails of distribution surrounding the mean
+    // use erase-remove : https://en.wikipedia.org/wiki/Erase%E2%80%93remove_idiom
+    v.erase(std::remove_if(v.begin(),
+                           v.end(),
+                           [med, nsigma, rms](const float& x) {
+                             return ((x < (med - nsigma * rms)) || (x > (med + nsigma * rms)));
+                           }), // lamdda condition for events to be removed
+            v.end());
+
+    // each iteration passes on the length limit and the iteration count in swapped places,
+    // as the recursive implementation did
+    lastmed = med;
+    size_t const next = limit;
+    limit = iteration + 1;
+    iteration = next;
+  }
 }
 
+namespace {
+
+  /// Binary indexed tree over value ranks, holding the count and sum of the values in a window
+  class RankedWindow {
+  public:
+    explicit RankedWindow(size_t nranks) : fCount(nranks + 1, 0), fSum(nranks + 1, 0.) {}
+
+    void Add(size_t rank, double value, int n)
+    {
+      for (size_t i = rank + 1; i < fCount.size(); i += i & (~i + 1)) {
+        fCount[i] += n;
+        fSum[i] += n * value;
+      }
+    }
+
+    /// Number and sum of the values with rank below `rank`
+    void Prefix(size_t rank, int& count, double& sum) const
+    {
+      count = 0;
+      sum = 0.;
+      for (size_t i = rank; i > 0; i -= i & (~i + 1)) {
+        count += fCount[i];
+        sum += fSum[i];
+      }
+    }
+
+    /// Rank of the k-th smallest value in the window (k starting from 0)
+    size_t Select(int k) const
+    {
+      size_t pos = 0;
+      size_t step = 1;
+      while (2 * step < fCount.size())
+        step *= 2;
+      for (; step > 0; step /= 2) {
+        if (pos + step < fCount.size() && fCount[pos + step] <= k) {
+          pos += step;
+          k -= fCount[pos];
+        }
+      }
+      return pos;
+    }
+
+  private:
+    std::vector<int> fCount;
+    std::vector<double> fSum;
+  };
+
+} // namespace
+
 void TruncMean::CalcTruncMeanProfile(const std::vector<float>& rr_v,
                                      const std::vector<float>& dq_v,
                                      std::vector<float>& dq_trunc_v,
                                      const float& nsigma)
 {
 
+  // the sliding window relies on the residual range being ordered
+  bool increasing = true;
+  bool decreasing = true;
+  for (size_t n = 1; n < dq_v.size(); n++) {
+    if (rr_v.at(n) < rr_v[n - 1]) increasing = false;
+    if (rr_v.at(n) > rr_v[n - 1]) decreasing = false;
+  }
+  if (!increasing && !decreasing) {
+    CalcTruncMeanProfileScan(rr_v, dq_v, dq_trunc_v, nsigma);
+    return;
+  }
+
+  // how many points to sample
+  int Nneighbor = (int)(_rad * 3 * 2);
+
+  dq_trunc_v.clear();
+  dq_trunc_v.reserve(rr_v.size());
+
+  int Nmax = dq_v.size() - 1;
+
+  // rank of each dq value among the distinct values of the track
+  std::vector<float> values_v(dq_v);
+  std::sort(values_v.begin(), values_v.end());
+  values_v.erase(std::unique(values_v.begin(), values_v.end()), values_v.end());
+  std::vector<size_t> rank_v(dq_v.size());
+  for (size_t i = 0; i < dq_v.size(); i++)
+    rank_v[i] = std::lower_bound(values_v.begin(), values_v.end(), dq_v[i]) - values_v.begin();
+
+  auto inRange = [&rr_v, this](int n, int i) {
+    float dr = rr_v[n] - rr_v[i];
+    if (dr < 0) dr *= -1;
+    return !(dr > _rad);
+  };
+
+  // current window [wmin, wmax) and the running sums of its values
+  RankedWindow window(values_v.size());
+  int wmin = 0;
+  int wmax = 0;
+  double sum = 0.;
+  double sum2 = 0.;
+  // first point after the current one that is out of the smearing radius
+  int rrmax = 0;
+
+  for (int n = 0; n < (int)dq_v.size(); n++) {
+
+    // both ends of the window only move forward because rr_v is ordered
+    int nmin = std::max(wmin, n - Nneighbor);
+    while (nmin < n && !inRange(n, nmin))
+      nmin++;
+
+    rrmax = std::max(rrmax, n + 1);
+    while (rrmax < (int)dq_v.size() && inRange(n, rrmax))
+      rrmax++;
+    int nmax = std::max(nmin, std::min({rrmax, n + Nneighbor, Nmax}));
+
+    for (; wmax < nmax; wmax++) {
+      window.Add(rank_v[wmax], dq_v[wmax], 1);
+      sum += dq_v[wmax];
+      sum2 += (double)dq_v[wmax] * dq_v[wmax];
+    }
+    for (; wmin < nmin; wmin++) {
+      window.Add(rank_v[wmin], dq_v[wmin], -1);
+      sum -= dq_v[wmin];
+      sum2 -= (double)dq_v[wmin] * dq_v[wmin];
+    }
+
+    int npts_local = wmax - wmin;
+    if (npts_local == 0) {
+      dq_trunc_v.push_back(dq_v.at(n));
+      continue;
+    }
+
+    // calculate median and rms
+    float median = values_v[window.Select(npts_local / 2)];
+    float rms = 0.;
+    if (npts_local == 1 || window.Select(0) == window.Select(npts_local - 1)) {
+      // the running sums cannot resolve a null spread: use the same float arithmetic as RMS()
+      float avg = 0.;
+      for (int i = wmin; i < wmax; i++)
+        avg += dq_v[i];
+      avg /= npts_local;
+      for (int i = wmin; i < wmax; i++)
+        rms += (dq_v[i] - avg) * (dq_v[i] - avg);
+      rms = sqrt(rms / (npts_local - 1));
+    }
+    else {
+      double var = (sum2 - sum * sum / npts_local) / (npts_local - 1);
+      rms = std::sqrt(std::max(var, 0.));
+    }
+
+    // values strictly within (median - rms * nsigma, median + rms * nsigma)
+    const float lo = median - rms * nsigma;
+    const float hi = median + rms * nsigma;
+    int npts = 0;
+    double truncated_dq = 0.;
+    if (lo < hi) {
+      size_t rlo = std::upper_bound(values_v.begin(), values_v.end(), lo) - values_v.begin();
+      size_t rhi = std::lower_bound(values_v.begin(), values_v.end(), hi) - values_v.begin();
+      int nlo = 0, nhi = 0;
+      double sumlo = 0., sumhi = 0.;
+      window.Prefix(rlo, nlo, sumlo);
+      window.Prefix(std::max(rlo, rhi), nhi, sumhi);
+      npts = nhi - nlo;
+      truncated_dq = sumhi - sumlo;
+    }
+
+    dq_trunc_v.push_back((float)truncated_dq / npts);
+  } // for all values
+
+  return;
+}
+
+void TruncMean::CalcTruncMeanProfileScan(const std::vector<float>& rr_v,
+                                         const std::vector<float>& dq_v,
+                                         std::vector<float>& dq_trunc_v,
+                                         const float& nsigma)
+{
+
   // how many points to sample
   int Nneighbor = (int)(_rad * 3 * 2);
 
@@ -12,6 +12,7 @@
 #ifndef TRUNCMEAN_H
 #define TRUNCMEAN_H
 
+#include <cstddef>
 #include <limits>
 #include <vector>
 
@@ -44,6 +45,9 @@ public:
      1) the median and rms of these values is calculated.
      2) the subset of local dq values within the range [median-rms, median+rms] is selected.
      3) the resulting local truncated dq is the average of this truncated subset.
+     The selected dq values are kept in a sliding window ordered by value, so that the
+     whole profile costs O(n log n) rather than a sort of the local values at every point.
+     If rr_v is not ordered, the local values are scanned and sorted point by point.
      @input std::vector<float> rr_v -> vector of x-axis coordinates (i.e. position for track profile)
      @input std::vector<float> dq_v -> vector of measured values for which truncated profile is requested
      (i.e. charge profile of a track)
@@ -75,12 +79,32 @@ public:
                                const float& nsigma,
                                const float& oldmed = kINVALID_FLOAT);
 
+  /**
+     @brief Same as CalcIterativeTruncMean(), trimming the caller's vector in place
+     No copy of the values is made: v is used as working buffer and on return it holds
+     the values kept by the last iteration, in unspecified order.
+   */
+  float CalcIterativeTruncMeanInPlace(std::vector<float>& v,
+                                      const size_t& nmin,
+                                      const size_t& nmax,
+                                      const size_t& currentiteration,
+                                      const size_t& lmin,
+                                      const float& convergencelimit,
+                                      const float& nsigma,
+                                      const float& oldmed = kINVALID_FLOAT);
+
   /**
      @brief Set the smearing radius over which to take hits for truncated mean computaton.
    */
   void setRadius(const float& rad) { _rad = rad; }
 
 private:
+  /// Point-by-point implementation of CalcTruncMeanProfile(), for unordered rr_v
+  void CalcTruncMeanProfileScan(const std::vector<float>& rr_v,
+                                const std::vector<float>& dq_v,
+                                std::vector<float>& dq_trunc_v,
+                                const float& nsigma);
+
   float Mean(const std::vector<float>& v);
   float Median(const std::vector<float>& v);
   float RMS(const std::vector<float>& v);
@@ -0,0 +1,173 @@
+/**
+ * @file   PIDAlgorithms_benchmark.cc
+ * @brief  Per-track latency of the truncated mean and particle ID algorithms.
+ *
+ * Synthetic dQ/dx and dE/dx sequences of a stopping particle are generated
+ * with a configurable number of points, and each algorithm is timed over
+ * all of them:
+ *
+ *     PIDAlgorithms_benchmark [track length (points)] [number of tracks]
+ *
+ * The chi2 templates are written to a temporary ROOT file which is made
+ * visible to Chi2PIDAlg through FW_SEARCH_PATH.
+ */
+
+#include "larana/ParticleIdentification/Chi2PIDAlg.h"
+#include "larana/ParticleIdentification/PIDAAlg.h"
+#include "larana/TruncatedMean/Algorithm/TruncMean.h"
+#include "lardataobj/AnalysisBase/Calorimetry.h"
+#include "lardataobj/AnalysisBase/ParticleID.h"
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include "TFile.h"
+#include "TProfile.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  struct SyntheticTrack {
+    std::vector<float> resRange;
+    std::vector<float> dQdx;
+    std::vector<float> dEdx;
+  };
+
+  /// Stopping proton-like track: dE/dx = A R^-0.42 with a Landau-like upper tail
+  std::vector<SyntheticTrack> MakeTracks(size_t npoints, size_t ntracks, float pitch)
+  {
+    std::mt19937 engine(12345);
+    std::normal_distribution<float> smear(1., 0.08);
+    std::exponential_distribution<float> tail(1. / 0.3);
+    std::uniform_real_distribution<float> flat(0., 1.);
+
+    std::vector<SyntheticTrack> tracks(ntracks);
+    for (auto& track : tracks) {
+      for (size_t i = 0; i < npoints; i++) {
+        float const rr = (npoints - i) * pitch;
+        float dedx = 17. * std::pow(rr, -0.42f) * smear(engine);
+        if (flat(engine) < 0.2) dedx *= 1. + tail(engine);
+        track.resRange.push_back(rr);
+        track.dEdx.push_back(dedx);
+        track.dQdx.push_back(dedx * 200.);
+      }
+    }
+    return tracks;
+  }
+
+  std::string WriteTemplates(std::string const& dir)
+  {
+    std::string const fileName = "PIDAlgorithms_benchmark_templates.root";
+    TFile file((dir + "/" + fileName).c_str(), "RECREATE");
+    std::vector<std::pair<std::string, float>> const species = {{"dedx_range_pro", 17.},
+                                                                {"dedx_range_ka", 14.},
+                                                                {"dedx_range_pi", 8.2},
+                                                                {"dedx_range_mu", 8.}};
+    for (auto const& [name, amplitude] : species) {
+      TProfile profile(name.c_str(), name.c_str(), 100, 0., 100.);
+      for (int bin = 1; bin <= profile.GetNbinsX(); bin++) {
+        float const rr = profile.GetBinCenter(bin);
+        float const dedx = amplitude * std::pow(rr, -0.42f);
+        profile.Fill(rr, 0.9 * dedx);
+        profile.Fill(rr, 1.1 * dedx);
+      }
+      profile.Write();
+    }
+    file.Close();
+    return fileName;
+  }
+
+  /// Runs the function once per track and prints the mean latency
+  void Time(std::string const& name, size_t ntracks, std::function<void(size_t)> const& f)
+  {
+    f(0); // warm up caches and lazy initialisation
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ntracks; i++)
+      f(i);
+    std::chrono::duration<double, std::micro> const elapsed =
+      std::chrono::steady_clock::now() - start;
+    std::cout << std::left << std::setw(32) << name << std::right << std::setw(12)
+              << std::fixed << std::setprecision(2) << elapsed.count() / ntracks
+              << " us/track" << std::endl;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  size_t const npoints = (argc > 1) ? std::stoul(argv[1]) : 200;
+  size_t const ntracks = (argc > 2) ? std::stoul(argv[2]) : 1000;
+  float const pitch = 0.3;
+
+  std::cout << "PIDAlgorithms_benchmark: " << ntracks << " tracks of " << npoints << " points"
+            << std::endl;
+
+  std::vector<SyntheticTrack> const tracks = MakeTracks(npoints, ntracks, pitch);
+
+  // sink for the results, so that the calls are not optimised away
+  volatile float sink = 0;
+
+  TruncMean truncMean;
+  truncMean.setRadius(3.);
+  Time("CalcIterativeTruncMean", ntracks, [&](size_t i) {
+    sink = truncMean.CalcIterativeTruncMean(tracks[i].dQdx, 1, 10, 0, 5, 0.1, 1.0);
+  });
+
+  std::vector<float> buffer;
+  Time("CalcIterativeTruncMeanInPlace", ntracks, [&](size_t i) {
+    buffer.assign(tracks[i].dQdx.begin(), tracks[i].dQdx.end());
+    sink = truncMean.CalcIterativeTruncMeanInPlace(buffer, 1, 10, 0, 5, 0.1, 1.0);
+  });
+
+  std::vector<float> profile;
+  Time("CalcTruncMeanProfile", ntracks, [&](size_t i) {
+    truncMean.CalcTruncMeanProfile(tracks[i].resRange, tracks[i].dQdx, profile);
+    sink = profile.back();
+  });
+
+  fhicl::ParameterSet pidaConfig;
+  pidaConfig.put("KDEBandwidths", std::vector<float>{0.0, 1.0});
+  pid::PIDAAlg pidaAlg(pidaConfig);
+  Time("PIDAAlg KDE", ntracks, [&](size_t i) {
+    pidaAlg.RunPIDAAlg(tracks[i].resRange, tracks[i].dEdx);
+    for (size_t i_b = 0; i_b < pidaAlg.getNKDEBandwidths(); i_b++)
+      sink = pidaAlg.getPIDAKDEMostProbable(i_b);
+  });
+
+  char const* tmpdir = std::getenv("TMPDIR");
+  std::string const templateDir = tmpdir ? tmpdir : "/tmp";
+  fhicl::ParameterSet chi2Config;
+  chi2Config.put("TemplateFile", WriteTemplates(templateDir));
+  chi2Config.put("UseMedian", true);
+  setenv("FW_SEARCH_PATH", templateDir.c_str(), 1);
+  pid::Chi2PIDAlg chi2Alg(chi2Config);
+
+  std::vector<anab::Calorimetry> calos;
+  for (auto const& track : tracks)
+    calos.emplace_back(0.,
+                       track.dEdx,
+                       track.dQdx,
+                       track.resRange,
+                       std::vector<float>{},
+                       npoints * pitch,
+                       pitch,
+                       geo::PlaneID(0, 0, 2));
+  Time("Chi2PIDAlg templates", ntracks, [&](size_t i) {
+    std::vector<art::Ptr<anab::Calorimetry>> const calo{
+      art::Ptr<anab::Calorimetry>(art::ProductID(), &calos[i], i)};
+    sink = (float)chi2Alg.DoParticleID(calo).ParticleIDAlgScores().size();
+  });
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+#define BOOST_TEST_MODULE (TruncMean_test)
+#include "boost/test/unit_test.hpp"
+
+#include "larana/TruncatedMean/Algorithm/TruncMean.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // verbatim copy of the recursive implementation the in-place iteration replaced
+  float Mean(const std::vector<float>& v)
+  {
+
+    float mean = 0.;
+    for (auto const& n : v)
+      mean += n;
+    mean /= v.size();
+
+    return mean;
+  }
+
+  float Median(const std::vector<float>& v)
+  {
+
+    if (v.size() == 1) return v[0];
+
+    std::vector<float> vcpy = v;
+
+    std::sort(vcpy.begin(), vcpy.end());
+
+    float median = vcpy[vcpy.size() / 2];
+
+    return median;
+  }
+
+  float RMS(const std::vector<float>& v)
+  {
+
+    float avg = 0.;
+    for (auto const& val : v)
+      avg += val;
+    avg /= v.size();
+    float rms = 0.;
+    for (auto const& val : v)
+      rms += (val - avg) * (val - avg);
+    rms = sqrt(rms / (v.size() - 1));
+
+    return rms;
+  }
+
+  float ReferenceTruncMean(std::vector<float> v,
+                           const size_t& nmin,
+                           const size_t& nmax,
+                           const size_t& currentiteration,
+                           const size_t& lmin,
+                           const float& convergencelimit,
+                           const float& nsigma,
+                           const float& oldmed = kINVALID_FLOAT)
+  {
+
+    auto const& mean = Mean(v);
+    auto const& med = Median(v);
+    auto const& rms = RMS(v);
+
+    // if the vector length is below the lower limit -> return
+    if (v.size() < lmin) return mean;
+
+    // if we have passed the maximum number of iterations -> return
+    if (currentiteration >= nmax) return mean;
+
+    // if we passed the minimum number of iterations and the mean is close enough to the old value
+    float fracdiff = fabs(med - oldmed) / oldmed;
+    if ((currentiteration >= nmin) && (fracdiff < convergencelimit)) return mean;
+
+    // if reached here it means we have to go on for another iteration
+
+    // cutoff tails of distribution surrounding the mean
+    // use erase-remove : https://en.wikipedia.org/wiki/Erase%E2%80%93remove_idiom
+    // https://stackoverflow.com/questions/17270837/stdvector-removing-elements-which-fulfill-some-conditions
+    v.erase(std::remove_if(v.begin(),
+                           v.end(),
+                           [med, nsigma, rms](const float& x) {
+                             return ((x < (med - nsigma * rms)) || (x > (med + nsigma * rms)));
+                           }), // lamdda condition for events to be removed
+            v.end());
+
+    return ReferenceTruncMean(
+      v, nmin, nmax, lmin, currentiteration + 1, convergencelimit, nsigma, med);
+  }
+
+  // Landau-like dQ/dx sample with a long upper tail
+  std::vector<float> MakeSample(size_t n, unsigned int seed)
+  {
+    std::mt19937 engine(seed);
+    std::normal_distribution<float> core(200., 20.);
+    std::exponential_distribution<float> tail(1. / 150.);
+    std::vector<float> v;
+    for (size_t i = 0; i < n; i++)
+      v.push_back(core(engine) + ((i % 5 == 0) ? tail(engine) : 0.f));
+    return v;
+  }
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(TruncMean_test)
+
+BOOST_AUTO_TEST_CASE(checkIterativeTruncMeanAgainstReference)
+{
+  TruncMean tm;
+
+  for (size_t n : {1, 2, 5, 20, 100, 1000}) {
+    std::vector<float> const sample = MakeSample(n, n);
+    for (size_t lmin : {1, 3, 10}) {
+      for (size_t nmin : {1, 2}) {
+        for (size_t nmax : {1, 3, 10}) {
+          for (float convergence : {0.1f, 0.01f}) {
+            for (float nsigma : {1.0f, 1.5f, 3.0f}) {
+              float const expected =
+                ReferenceTruncMean(sample, nmin, nmax, 0, lmin, convergence, nsigma);
+
+              BOOST_TEST(tm.CalcIterativeTruncMean(
+                           sample, nmin, nmax, 0, lmin, convergence, nsigma) == expected,
+                         boost::test_tools::tolerance(1e-5f));
+
+              std::vector<float> buffer = sample;
+              BOOST_TEST(tm.CalcIterativeTruncMeanInPlace(
+                           buffer, nmin, nmax, 0, lmin, convergence, nsigma) == expected,
+                         boost::test_tools::tolerance(1e-5f));
+              BOOST_TEST(buffer.size() <= sample.size());
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(checkTruncMeanProfileOrdering)
+{
+  // the sliding window and the point-by-point scan must agree
+  std::vector<float> const dq_v = MakeSample(300, 7);
+  std::vector<float> rr_v;
+  for (size_t i = 0; i < dq_v.size(); i++)
+    rr_v.push_back(0.3 * i);
+
+  TruncMean tm;
+  tm.setRadius(5.);
+
+  std::vector<float> forward;
+  tm.CalcTruncMeanProfile(rr_v, dq_v, forward);
+  BOOST_TEST(forward.size() == dq_v.size());
+
+  // an unordered residual range with the same spacing takes the scan path
+  std::vector<float> shuffled_rr = rr_v;
+  std::swap(shuffled_rr.front(), shuffled_rr.back());
+  std::vector<float> scanned;
+  tm.CalcTruncMeanProfile(shuffled_rr, dq_v, scanned);
+
+  // only points near the swapped ends can differ
+  for (size_t i = 20; i + 20 < dq_v.size(); i++)
+    BOOST_TEST(forward[i] == scanned[i], boost::test_tools::tolerance(1e-4f));
+}
+
+BOOST_AUTO_TEST_SUITE_END()